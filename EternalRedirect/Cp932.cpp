@@ -0,0 +1,387 @@
+/*
+ *  File: Cp932.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "Cp932.hpp"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define CP932_SIMD 1
+#else
+#define CP932_SIMD 0
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace cp932
+{
+static const uint8_t REPLACEMENT_CHAR = '?';
+
+#if CP932_SIMD
+static uint32_t lowestSetBit(const uint32_t value)
+{
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanForward(&idx, value);
+	return static_cast<uint32_t>(idx);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+//
+// Classify a block of input bytes, bit i of nonAscii is set if byte i is not ASCII,
+// bit i of other is set if byte i is neither ASCII nor half-width katakana (0xA1 - 0xDF)
+//
+#ifdef __AVX2__
+static const size_t BLOCK_SIZE = 32;
+
+static void classifyBlock(const uint8_t* pData, uint32_t& nonAscii, uint32_t& other)
+{
+	const __m256i bytes  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData));
+	const __m256i offset = _mm256_sub_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0xA1)));
+	const __m256i isKana = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(0x3E)), offset);
+
+	nonAscii = static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+	other    = nonAscii & ~static_cast<uint32_t>(_mm256_movemask_epi8(isKana));
+}
+#else
+static const size_t BLOCK_SIZE = 16;
+
+static void classifyBlock(const uint8_t* pData, uint32_t& nonAscii, uint32_t& other)
+{
+	const __m128i bytes  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData));
+	const __m128i offset = _mm_sub_epi8(bytes, _mm_set1_epi8(static_cast<char>(0xA1)));
+	const __m128i isKana = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(0x3E)), offset);
+
+	nonAscii = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+	other    = nonAscii & ~static_cast<uint32_t>(_mm_movemask_epi8(isKana));
+}
+#endif
+#endif
+
+static uint8_t* writeUtf8(const uint32_t codePoint, uint8_t* pOut)
+{
+	if (codePoint < 0x80)
+		*pOut++ = static_cast<uint8_t>(codePoint);
+	else if (codePoint < 0x800)
+	{
+		*pOut++ = static_cast<uint8_t>(0xC0 | (codePoint >> 6));
+		*pOut++ = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		*pOut++ = static_cast<uint8_t>(0xE0 | (codePoint >> 12));
+		*pOut++ = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+		*pOut++ = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+	}
+
+	return pOut;
+}
+
+// Half-width katakana 0xA1 - 0xDF map to U+FF61 - U+FF9F, i.e. EF BD A1 - EF BD BF and EF BE 80 - EF BE 9F
+static uint8_t* writeKana(const uint8_t c, uint8_t* pOut)
+{
+	*pOut++ = 0xEF;
+	*pOut++ = c < 0xC0 ? 0xBD : 0xBE;
+	*pOut++ = c < 0xC0 ? c : static_cast<uint8_t>(c - 0x40);
+	return pOut;
+}
+
+// Code point of a single byte that is neither ASCII, half-width katakana nor a lead byte
+static uint32_t singleByteCodePoint(const uint8_t c)
+{
+	if (c == 0x80)
+		return 0x80;
+
+	// 0xA0 and 0xFD - 0xFF are mapped to the private use area by Windows
+	if (c == 0xA0)
+		return 0xF8F0;
+
+	return 0xF8F1 + (c - 0xFD);
+}
+
+static uint32_t leadIndex(const uint8_t c)
+{
+	return c <= 0x9F ? c - 0x81 : c - 0xE0 + 0x1F;
+}
+
+// Shift-JIS form of a code point packed like in UNICODE_PAGES, 0 if it has none
+static uint16_t encodeCodePoint(const uint32_t codePoint)
+{
+	const uint8_t page = codePoint <= 0xFFFF ? UNICODE_PAGE_INDEX[codePoint >> 8] : 0;
+	return page != 0 ? UNICODE_PAGES[(page - 1) * 256 + (codePoint & 0xFF)] : 0;
+}
+
+size_t toUtf8(const char* pSjis, size_t length, char* pOut)
+{
+	const uint8_t* pSrc = reinterpret_cast<const uint8_t*>(pSjis);
+	const uint8_t* pEnd = pSrc + length;
+	uint8_t* pDst       = reinterpret_cast<uint8_t*>(pOut);
+
+	while (pSrc < pEnd)
+	{
+#if CP932_SIMD
+		if (static_cast<size_t>(pEnd - pSrc) >= BLOCK_SIZE)
+		{
+			uint32_t nonAscii;
+			uint32_t other;
+			classifyBlock(pSrc, nonAscii, other);
+
+			if (nonAscii == 0)
+			{
+				memcpy(pDst, pSrc, BLOCK_SIZE);
+				pSrc += BLOCK_SIZE;
+				pDst += BLOCK_SIZE;
+				continue;
+			}
+
+			// Everything in front of the first byte that needs a table lookup is a complete single byte character
+			const size_t run = other == 0 ? BLOCK_SIZE : lowestSetBit(other);
+
+			for (size_t i = 0; i < run; i++)
+			{
+				const uint8_t c = pSrc[i];
+				if (c < 0x80)
+					*pDst++ = c;
+				else
+					pDst = writeKana(c, pDst);
+			}
+
+			pSrc += run;
+			if (run == BLOCK_SIZE)
+				continue;
+		}
+#endif
+
+		const uint8_t c = *pSrc++;
+
+		if (c < 0x80)
+			*pDst++ = c;
+		else if (c >= 0xA1 && c <= 0xDF)
+			pDst = writeKana(c, pDst);
+		else if (!isLeadByte(c))
+			pDst = writeUtf8(singleByteCodePoint(c), pDst);
+		else if (pSrc < pEnd && *pSrc >= TRAIL_FIRST && *pSrc <= TRAIL_LAST)
+		{
+			const uint16_t codePoint = DOUBLE_BYTE_TABLE[leadIndex(c) * TRAIL_COUNT + (*pSrc++ - TRAIL_FIRST)];
+			pDst                     = writeUtf8(codePoint != 0 ? codePoint : DEFAULT_CHAR, pDst);
+		}
+		else
+			pDst = writeUtf8(DEFAULT_CHAR, pDst);
+	}
+
+	return static_cast<size_t>(pDst - reinterpret_cast<uint8_t*>(pOut));
+}
+
+//
+// Decode a single UTF-8 sequence starting with a non-ASCII byte.
+// Returns the number of bytes consumed and sets codePoint to UINT32_MAX for invalid or overlong sequences.
+//
+static size_t readUtf8(const uint8_t* pSrc, const uint8_t* pEnd, uint32_t& codePoint)
+{
+	const uint8_t c = pSrc[0];
+	size_t length;
+	uint32_t minimum;
+
+	if (c >= 0xC2 && c <= 0xDF)
+	{
+		length    = 2;
+		minimum   = 0x80;
+		codePoint = c & 0x1F;
+	}
+	else if (c >= 0xE0 && c <= 0xEF)
+	{
+		length    = 3;
+		minimum   = 0x800;
+		codePoint = c & 0x0F;
+	}
+	else if (c >= 0xF0 && c <= 0xF4)
+	{
+		length    = 4;
+		minimum   = 0x10000;
+		codePoint = c & 0x07;
+	}
+	else
+	{
+		codePoint = UINT32_MAX;
+		return 1;
+	}
+
+	if (static_cast<size_t>(pEnd - pSrc) < length)
+	{
+		codePoint = UINT32_MAX;
+		return 1;
+	}
+
+	for (size_t i = 1; i < length; i++)
+	{
+		if ((pSrc[i] & 0xC0) != 0x80)
+		{
+			codePoint = UINT32_MAX;
+			return i;
+		}
+
+		codePoint = (codePoint << 6) | (pSrc[i] & 0x3F);
+	}
+
+	if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint < 0xE000))
+		codePoint = UINT32_MAX;
+
+	return length;
+}
+
+size_t toSjis(const char* pUtf8, size_t length, char* pOut)
+{
+	const uint8_t* pSrc = reinterpret_cast<const uint8_t*>(pUtf8);
+	const uint8_t* pEnd = pSrc + length;
+	uint8_t* pDst       = reinterpret_cast<uint8_t*>(pOut);
+
+	while (pSrc < pEnd)
+	{
+#if CP932_SIMD
+		if (static_cast<size_t>(pEnd - pSrc) >= BLOCK_SIZE)
+		{
+			uint32_t nonAscii;
+			uint32_t other;
+			classifyBlock(pSrc, nonAscii, other);
+
+			const size_t run = nonAscii == 0 ? BLOCK_SIZE : lowestSetBit(nonAscii);
+			memcpy(pDst, pSrc, run);
+			pSrc += run;
+			pDst += run;
+
+			if (run == BLOCK_SIZE)
+				continue;
+		}
+#endif
+
+		const uint8_t c = *pSrc;
+
+		if (c < 0x80)
+		{
+			*pDst++ = c;
+			pSrc++;
+			continue;
+		}
+
+		// Half-width katakana are the most common non-ASCII characters in game text that are not double byte
+		if (c == 0xEF && pEnd - pSrc >= 3 && ((pSrc[1] == 0xBD && pSrc[2] >= 0xA1 && pSrc[2] <= 0xBF) || (pSrc[1] == 0xBE && pSrc[2] >= 0x80 && pSrc[2] <= 0x9F)))
+		{
+			*pDst++ = pSrc[1] == 0xBD ? pSrc[2] : static_cast<uint8_t>(pSrc[2] + 0x40);
+			pSrc += 3;
+			continue;
+		}
+
+		uint32_t codePoint;
+		pSrc += readUtf8(pSrc, pEnd, codePoint);
+
+		const uint16_t sjis = encodeCodePoint(codePoint);
+
+		if (sjis == 0)
+			*pDst++ = REPLACEMENT_CHAR;
+		else if (sjis <= 0xFF)
+			*pDst++ = static_cast<uint8_t>(sjis);
+		else
+		{
+			*pDst++ = static_cast<uint8_t>(sjis >> 8);
+			*pDst++ = static_cast<uint8_t>(sjis & 0xFF);
+		}
+	}
+
+	return static_cast<size_t>(pDst - reinterpret_cast<uint8_t*>(pOut));
+}
+
+//
+// Form toSjis produces for the character, which is the character itself unless it exists more than once.
+// Every duplicate encodes to another double byte character, so the length never changes.
+//
+static uint16_t canonicalPair(const uint8_t lead, const uint8_t trail)
+{
+	const uint16_t pair = static_cast<uint16_t>((lead << 8) | trail);
+
+	if (trail < TRAIL_FIRST || trail > TRAIL_LAST)
+		return pair;
+
+	const uint16_t codePoint = DOUBLE_BYTE_TABLE[leadIndex(lead) * TRAIL_COUNT + (trail - TRAIL_FIRST)];
+	const uint16_t encoded   = codePoint != 0 ? encodeCodePoint(codePoint) : 0;
+
+	return encoded > 0xFF ? encoded : pair;
+}
+
+size_t findNonCanonical(std::string_view sjis)
+{
+	const uint8_t* pData = reinterpret_cast<const uint8_t*>(sjis.data());
+
+	for (size_t i = 0; i + 1 < sjis.size(); i++)
+	{
+		if (!isLeadByte(pData[i]))
+			continue;
+
+		if (canonicalPair(pData[i], pData[i + 1]) != ((pData[i] << 8) | pData[i + 1]))
+			return i;
+
+		i++;
+	}
+
+	return std::string_view::npos;
+}
+
+void canonicalize(char* pSjis, const size_t length, const size_t offset)
+{
+	uint8_t* pData = reinterpret_cast<uint8_t*>(pSjis);
+
+	for (size_t i = offset; i + 1 < length; i++)
+	{
+		if (!isLeadByte(pData[i]))
+			continue;
+
+		const uint16_t pair = canonicalPair(pData[i], pData[i + 1]);
+		pData[i]            = static_cast<uint8_t>(pair >> 8);
+		pData[i + 1]        = static_cast<uint8_t>(pair & 0xFF);
+
+		i++;
+	}
+}
+
+void appendUtf8(std::string_view sjis, std::string& out)
+{
+	const size_t offset = out.size();
+	out.resize(offset + maxUtf8Size(sjis.size()));
+	out.resize(offset + toUtf8(sjis.data(), sjis.size(), &out[offset]));
+}
+
+void appendSjis(std::string_view utf8, std::string& out)
+{
+	const size_t offset = out.size();
+	out.resize(offset + maxSjisSize(utf8.size()));
+	out.resize(offset + toSjis(utf8.data(), utf8.size(), &out[offset]));
+}
+} // namespace cp932
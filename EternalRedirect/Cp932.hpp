@@ -0,0 +1,99 @@
+/*
+ *  File: Cp932.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+//
+// Shift-JIS (code page 932) <-> UTF-8 conversion without going through UTF-16 or the Win32 API.
+// Follows the mapping of MultiByteToWideChar(932, ...) and WideCharToMultiByte(932, ...), including the form Windows
+// picks for characters that exist more than once. Characters that cannot be encoded become '?', Windows' best fit
+// replacements like U+00C0 to 'A' are not applied.
+// Undefined or truncated double byte characters decode to U+30FB, the default character of code page 932.
+//
+namespace cp932
+{
+static constexpr uint8_t LEAD_COUNT   = 60;
+static constexpr uint8_t TRAIL_FIRST  = 0x40;
+static constexpr uint8_t TRAIL_LAST   = 0xFC;
+static constexpr uint16_t TRAIL_COUNT = TRAIL_LAST - TRAIL_FIRST + 1;
+
+static constexpr uint16_t DEFAULT_CHAR = 0x30FB;
+
+// Lookup tables, generated into Cp932Tables.cpp by scripts/gen_cp932_tables.py.
+// DOUBLE_BYTE_TABLE maps [lead index][trail - TRAIL_FIRST] to a code point, 0 if the pair is not mapped.
+// UNICODE_PAGE_INDEX maps the upper byte of a code point to its page in UNICODE_PAGES plus one, 0 if the page is empty.
+// Pages store single byte characters as is and double byte characters as (lead << 8) | trail, 0 if not mapped.
+extern const uint16_t DOUBLE_BYTE_TABLE[LEAD_COUNT * TRAIL_COUNT];
+extern const uint8_t UNICODE_PAGE_INDEX[256];
+extern const uint16_t UNICODE_PAGES[];
+
+inline bool isLeadByte(const uint8_t c)
+{
+	return (c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC);
+}
+
+// True if the two bytes form a double byte character that has a mapping
+inline bool isDoubleByteChar(const uint8_t lead, const uint8_t trail)
+{
+	if (!isLeadByte(lead) || trail < TRAIL_FIRST || trail > TRAIL_LAST)
+		return false;
+
+	const uint32_t leadIndex = (lead <= 0x9F) ? lead - 0x81 : lead - 0xE0 + 0x1F;
+	return DOUBLE_BYTE_TABLE[leadIndex * TRAIL_COUNT + (trail - TRAIL_FIRST)] != 0;
+}
+
+// Upper bound of the output size, the output buffers passed below must be at least this large
+constexpr size_t maxUtf8Size(const size_t sjisLength)
+{
+	return sjisLength * 3;
+}
+
+constexpr size_t maxSjisSize(const size_t utf8Length)
+{
+	return utf8Length;
+}
+
+// Convert into a caller provided buffer, returns the number of bytes written. No null terminator is added.
+size_t toUtf8(const char* pSjis, size_t length, char* pOut);
+size_t toSjis(const char* pUtf8, size_t length, char* pOut);
+
+// Append the converted text to out, existing content is kept so buffers can be reused between calls
+void appendUtf8(std::string_view sjis, std::string& out);
+void appendSjis(std::string_view utf8, std::string& out);
+
+// Some characters exist more than once, e.g. the IBM extensions (0xFA - 0xFC) repeat in the NEC selected block (0xED, 0xEE)
+// and partly in NEC row 13 (0x87) and JIS X 0208. All forms decode to the same code point.
+// Returns the offset of the first double byte character that toSjis would encode differently or std::string_view::npos.
+size_t findNonCanonical(std::string_view sjis);
+
+// Replaces every double byte character from offset on with the form toSjis produces for it, the length stays the same
+void canonicalize(char* pSjis, const size_t length, const size_t offset = 0);
+} // namespace cp932
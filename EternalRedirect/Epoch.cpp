@@ -0,0 +1,101 @@
+/*
+ *  File: Epoch.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "Epoch.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace epoch
+{
+// Starts at 1, a record epoch of 0 means the thread is not reading
+std::atomic<uint64_t> g_epoch = 1;
+
+std::mutex g_recordsMutex;
+std::vector<std::unique_ptr<ThreadRecord>> g_records;
+
+// Records of exited threads, they are never freed because synchronize may still be polling them
+std::vector<ThreadRecord*> g_freeRecords;
+
+ThreadRecord* registerThread()
+{
+	std::lock_guard<std::mutex> lock(g_recordsMutex);
+
+	if (!g_freeRecords.empty())
+	{
+		ThreadRecord* pRecord = g_freeRecords.back();
+		g_freeRecords.pop_back();
+		return pRecord;
+	}
+
+	g_records.push_back(std::make_unique<ThreadRecord>());
+	return g_records.back().get();
+}
+
+void unregisterThread()
+{
+	ThreadRecord*& pRecord = threadRecordSlot();
+	if (pRecord == nullptr)
+		return;
+
+	std::lock_guard<std::mutex> lock(g_recordsMutex);
+
+	g_freeRecords.push_back(pRecord);
+	pRecord = nullptr;
+}
+
+void synchronize()
+{
+	const uint64_t newEpoch = g_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+	// Threads registering later can only see the new epoch, copying the list keeps registerThread from blocking on this wait
+	std::vector<ThreadRecord*> records;
+
+	{
+		std::lock_guard<std::mutex> lock(g_recordsMutex);
+
+		for (const std::unique_ptr<ThreadRecord>& pRecord : g_records)
+			records.push_back(pRecord.get());
+	}
+
+	for (ThreadRecord* pRecord : records)
+	{
+		// Readers stay in a hook for microseconds, so polling is cheaper than making them signal
+		for (;;)
+		{
+			const uint64_t recordEpoch = pRecord->epoch.load(std::memory_order_seq_cst);
+
+			if (recordEpoch == 0 || recordEpoch >= newEpoch)
+				break;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+} // namespace epoch
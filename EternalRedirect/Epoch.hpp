@@ -0,0 +1,104 @@
+/*
+ *  File: Epoch.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//
+// Epoch based reclamation for data that is read by the hooks and replaced by other threads.
+// Readers only publish the epoch they entered in, they never wait or take a lock.
+// A writer swaps the shared pointer, calls synchronize and can then free the old data.
+//
+namespace epoch
+{
+struct ThreadRecord
+{
+	// Epoch the thread entered its outermost read section in, 0 while it is not reading
+	std::atomic<uint64_t> epoch = 0;
+	uint32_t depth              = 0;
+};
+
+extern std::atomic<uint64_t> g_epoch;
+
+// Registers a record for the calling thread, records of exited threads are reused instead of allocating a new one
+ThreadRecord* registerThread();
+
+// Returns the record of the calling thread for reuse, must be called outside of any read section before the thread exits
+void unregisterThread();
+
+inline ThreadRecord*& threadRecordSlot()
+{
+	thread_local ThreadRecord* t_pRecord = nullptr;
+	return t_pRecord;
+}
+
+inline ThreadRecord& threadRecord()
+{
+	ThreadRecord*& pRecord = threadRecordSlot();
+
+	if (pRecord == nullptr)
+		pRecord = registerThread();
+
+	return *pRecord;
+}
+
+//
+// Keeps everything loaded from an epoch protected pointer alive until the guard is destroyed.
+// Guards can be nested, only the outermost one is visible to writers.
+//
+class ReadGuard
+{
+public:
+	ReadGuard() :
+		m_record(threadRecord())
+	{
+		if (m_record.depth++ == 0)
+		{
+			// Must be visible before the protected pointer is loaded, pairs with the scan in synchronize
+			m_record.epoch.store(g_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	~ReadGuard()
+	{
+		if (--m_record.depth == 0)
+			m_record.epoch.store(0, std::memory_order_release);
+	}
+
+	ReadGuard(const ReadGuard&)            = delete;
+	ReadGuard& operator=(const ReadGuard&) = delete;
+
+private:
+	ThreadRecord& m_record;
+};
+
+// Starts a new epoch and waits until no thread is still reading in an older one.
+// Data unpublished before the call can be freed once it returns.
+void synchronize();
+} // namespace epoch
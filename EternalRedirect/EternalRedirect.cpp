@@ -24,14 +24,30 @@
  *
  */
 
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <windows.h>
+#include <tlhelp32.h>
 
 #include <detours.h>
-#include <nlohmann/json.hpp>
 
+#include "Epoch.hpp"
+#include "FileWatcher.hpp"
+#include "FontMetrics.hpp"
+#include "HookStats.hpp"
+#include "SignatureCache.hpp"
+#include "SignatureScanner.hpp"
+#include "TranslationHooks.hpp"
+#include "TranslationLoader.hpp"
+#include "TranslationLookup.hpp"
+#include "TranslationTable.hpp"
 #include "Utils.hpp"
 
 #include "Logging.hpp"
@@ -46,43 +62,56 @@ VOID DetDetach(PVOID* ppbReal, PVOID pbMine, const char* psz);
 #define ATTACH(x) DetAttach(&(PVOID&)Real_##x, Mine_##x, #x)
 #define DETACH(x) DetDetach(&(PVOID&)Real_##x, Mine_##x, #x)
 
-struct TranslationEntry
-{
-	TranslationEntry() = default;
-	TranslationEntry(const std::string& t, const uint32_t& pl) :
-		text(t), pixelLength(pl) {}
+// Published by the loader and reload threads, hooks pass everything through while it is still null.
+// Hooks have to hold an epoch::ReadGuard while using a snapshot, replaced snapshots are freed once no hook can see them anymore.
+std::atomic<TranslationSnapshot*> g_pTranslations = nullptr;
+std::mutex g_publishMutex;
+uint64_t g_snapshotGeneration = 0;
 
-	std::string text     = "";
-	uint32_t pixelLength = 0;
+HANDLE g_hTranslationsReady               = nullptr;
+DWORD g_translationsWaitMs                = 0;
+std::atomic<bool> g_waitedForTranslations = false;
 
-	void clear()
-	{
-		text        = "";
-		pixelLength = 0;
-	}
+const BYTE* g_pRData = nullptr;
+size_t g_rdataSize   = 0;
 
-	bool operator<(const uint32_t& other) const
-	{
-		return pixelLength < other;
-	}
+FileWatcher g_translationWatcher;
 
-	bool operator>(const uint32_t& other) const
-	{
-		return pixelLength > other;
-	}
-};
+#if INCLUDE_DEBUG_LOGGING
+LARGE_INTEGER g_attachTime = {};
+#endif
 
-nlohmann::json g_translations;
 TranslationEntry g_largestCopiedStrSinceResize = {};
 
-static const std::string TRANSLATIONS_FILE = "tr.json";
-static const std::string WINDOW_TITLE_KEY  = "window_title";
+thread_local ScratchBuffer t_scratchBuffer;
+
+static const std::string TRANSLATIONS_FILE      = "tr.json";
+static const std::string TRANSLATIONS_PACK_FILE = "tr.pack";
+static const std::string SIGNATURE_CACHE_FILE   = "eternal_hooks.cache";
 
-static const std::vector<BYTE> DRAW_FORMAT_VSTRING_FUNC          = { 0x40, 0x53, 0x55, 0x56, 0x41, 0x56, 0x41, 0x57, 0x48, 0x81 };
-static const std::vector<BYTE> COPY_FUNC                         = { 0x48, 0x89, 0x5C, 0x24, 0x10, 0x57, 0x48, 0x83, 0xEC, 0x20, 0x48, 0x8B, 0xF9, 0x48, 0xC7, 0xC3 };
-static const std::vector<BYTE> GET_DRAW_FORMAT_STRING_WIDTH_FUNC = { 0x48, 0x89, 0x4C, 0x24, 0x08, 0x48, 0x89, 0x54, 0x24, 0x10, 0x4C, 0x89, 0x44, 0x24, 0x18, 0x4C, 0x89, 0x4C, 0x24, 0x20, 0x53, 0x56 };
-static const std::vector<BYTE> SET_WINDOW_TITLE_FUNC             = { 0x48, 0x89, 0x5C, 0x24, 0x20, 0x55, 0x56, 0x57, 0x41, 0x55, 0x41, 0x57, 0x48, 0x81, 0xEC, 0x40, 0x04, 0x00, 0x00, 0x48, 0x8B, 0x05, 0xA6, 0x92 };
-static const std::vector<BYTE> COPY_ENEMY_NAME_FUNC              = { 0x40, 0x53, 0x55, 0x57, 0x41, 0x56, 0x48, 0x83, 0xEC, 0x28, 0x48, 0xBF, 0xFF, 0xFF, 0xFF, 0xFF };
+// Hooked calls may wait this many milliseconds for the translations once, so the title screen does not switch languages
+static const char* TRANSLATIONS_WAIT_VARIABLE = "ETERNAL_TRANSLATIONS_WAIT_MS";
+
+// Set to anything but 0 to reload the translations whenever tr.json or tr.pack changes
+static const char* HOT_RELOAD_VARIABLE = "ETERNAL_HOT_RELOAD";
+
+// Games with more code than this are scanned on a separate thread using several workers
+static const size_t PARALLEL_SCAN_THRESHOLD = 16 * 1024 * 1024;
+static const uint32_t MAX_SCAN_THREADS      = 8;
+
+#if INCLUDE_HOOK_STATS
+static const std::string HOOK_STATS_FILE = "hook_stats.txt";
+static const int HOOK_STATS_HOTKEY       = VK_F12;
+
+HANDLE g_hStatsStopEvent = nullptr;
+#endif
+
+// IDA style signatures, ?? matches any byte
+static const std::string DRAW_FORMAT_VSTRING_FUNC          = "40 53 55 56 41 56 41 57 48 81";
+static const std::string COPY_FUNC                         = "48 89 5C 24 10 57 48 83 EC 20 48 8B F9 48 C7 C3";
+static const std::string GET_DRAW_FORMAT_STRING_WIDTH_FUNC = "48 89 4C 24 08 48 89 54 24 10 4C 89 44 24 18 4C 89 4C 24 20 53 56";
+static const std::string SET_WINDOW_TITLE_FUNC             = "48 89 5C 24 20 55 56 57 41 55 41 57 48 81 EC 40 04 00 00 48 8B 05 ?? ??";
+static const std::string COPY_ENEMY_NAME_FUNC              = "40 53 55 57 41 56 48 83 EC 28 48 BF FF FF FF FF";
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -107,18 +136,20 @@ extern "C"
 //
 //////////////////////////////////////////////////////////////////////////////
 
-bool getEntryAndCheck(const std::string& key, nlohmann::json& outEntry)
+//
+// Returns the published translations or nullptr if they are not loaded yet, the caller must hold an epoch::ReadGuard
+//
+TranslationSnapshot* currentTranslations()
 {
-	if (g_translations.contains(key))
-	{
-		const nlohmann::json& entry = g_translations[key];
-		if (!entry.contains("text") || !entry.contains("pixel_lengths"))
-			return false;
+	TranslationSnapshot* pSnapshot = g_pTranslations.load(std::memory_order_acquire);
 
-		outEntry = entry;
-		return true;
+	if (pSnapshot == nullptr && g_translationsWaitMs != 0 && !g_waitedForTranslations.exchange(true))
+	{
+		WaitForSingleObject(g_hTranslationsReady, g_translationsWaitMs);
+		pSnapshot = g_pTranslations.load(std::memory_order_acquire);
 	}
-	return false;
+
+	return pSnapshot;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -127,150 +158,77 @@ bool getEntryAndCheck(const std::string& key, nlohmann::json& outEntry)
 
 VOID* WINAPI Mine_CopyEnemyNameFunc(void* a1, uint8_t* a2, size_t a3)
 {
-	VOID* result = nullptr;
+	stats::HookScope scope(stats::Hook::CopyEnemyNameFunc);
+	epoch::ReadGuard guard;
 
-	std::string utf8String = sjis2utf8(reinterpret_cast<const char*>(a2));
-	// Check if this string exists in the translations
-	if (g_translations.contains(utf8String))
-	{
-		nlohmann::json entry;
+	size_t length = 0;
+	char* pCopy   = copyTranslation(currentTranslations(), reinterpret_cast<const char*>(a2), t_scratchBuffer, scope, nullptr, length);
 
-		if (!getEntryAndCheck(utf8String, entry))
-			return Real_CopyEnemyNameFunc(a1, a2, a3);
+	if (pCopy != nullptr)
+		return Real_CopyEnemyNameFunc(a1, reinterpret_cast<uint8_t*>(pCopy), length);
 
-		std::string tStr = utf82sjis(entry["text"]);
-		uint8_t* pBuffer = new uint8_t[tStr.size() + 1]();
-		memcpy(pBuffer, tStr.c_str(), tStr.size());
-		result = Real_CopyEnemyNameFunc(a1, pBuffer, tStr.size());
-		delete[] pBuffer;
-	}
-	else
-		result = Real_CopyEnemyNameFunc(a1, a2, a3);
-	return result;
+	return Real_CopyEnemyNameFunc(a1, a2, a3);
 }
 
 int64_t WINAPI Mine_SetWindowTitle(const char* WindowText)
 {
+	stats::HookScope scope(stats::Hook::SetWindowTitle);
+	epoch::ReadGuard guard;
+
 	int64_t result = -1;
 
+	const TranslationSnapshot* pSnapshot = currentTranslations();
+
 	// Check if this string exists in the translations
-	if (g_translations.contains(WINDOW_TITLE_KEY))
+	if (pSnapshot != nullptr && pSnapshot->table.hasWindowTitle())
 	{
-		std::string translatedString = g_translations[WINDOW_TITLE_KEY];
-
-		result = Real_SetWindowTitle(translatedString.c_str());
+		scope.hit(strlen(pSnapshot->table.windowTitle()));
+		result = Real_SetWindowTitle(pSnapshot->table.windowTitle());
 	}
 	else
+	{
+		scope.miss();
 		result = Real_SetWindowTitle(WindowText);
+	}
 
 	return result;
 }
 
 int64_t WINAPI Mine_GetDrawFormatStringWidth(const char* FormatString, ...)
 {
-	int64_t result = -1;
-
-	std::string utf8String = sjis2utf8(FormatString);
-
-	// Check if this string exists in the translations
-	if (g_translations.contains(utf8String))
-	{
-		nlohmann::json entry;
-
-		if (!getEntryAndCheck(utf8String, entry))
-			return Real_GetDrawFormatStringWidth(FormatString);
-
-		std::string tStr = entry["text"];
-
-		const std::vector<uint32_t> pixelLengths = entry["pixel_lengths"].get<std::vector<uint32_t>>();
+	stats::HookScope scope(stats::Hook::GetDrawFormatStringWidth);
+	epoch::ReadGuard guard;
 
-		// This should only have a single entry so just take the first -- Maybe expand later if needed
-		const uint32_t pixelLength = pixelLengths.empty() ? 0 : pixelLengths[0];
-
-		// Now determine which is the largest string
-		if (g_largestCopiedStrSinceResize > pixelLength)
-			tStr = g_largestCopiedStrSinceResize.text;
-
-		// Clear the largest string since resize after using it
-		g_largestCopiedStrSinceResize.clear();
-		tStr   = utf82sjis(tStr);
-		result = Real_GetDrawFormatStringWidth(tStr.c_str());
-	}
-	else
-	{
-		result = Real_GetDrawFormatStringWidth(FormatString);
-	}
-
-	return result;
+	return Real_GetDrawFormatStringWidth(widthString(currentTranslations(), FormatString, scope, g_largestCopiedStrSinceResize));
 }
 
 VOID* WINAPI Mine_CopyFunc(void* a1, uint8_t* a2, int64_t a3)
 {
-	VOID* result = nullptr;
-
-	std::string utf8String = sjis2utf8(reinterpret_cast<const char*>(a2));
-	// Check if this string exists in the translations
-	if (g_translations.contains(utf8String))
-	{
-		nlohmann::json entry;
+	stats::HookScope scope(stats::Hook::CopyFunc);
+	epoch::ReadGuard guard;
 
-		if (!getEntryAndCheck(utf8String, entry))
-			return Real_CopyFunc(a1, a2, a3);
+	size_t length = 0;
+	char* pCopy   = copyTranslation(currentTranslations(), reinterpret_cast<const char*>(a2), t_scratchBuffer, scope, &g_largestCopiedStrSinceResize, length);
 
-		std::string tStr                   = entry["text"];
-		std::vector<uint32_t> pixelLengths = entry["pixel_lengths"].get<std::vector<uint32_t>>();
-		std::vector<std::string> lines     = splitString(tStr, '\n');
+	if (pCopy != nullptr)
+		return Real_CopyFunc(a1, reinterpret_cast<uint8_t*>(pCopy), a3);
 
-		// Find the largest line by pixel length
-		for (size_t i = 0; i < lines.size(); i++)
-		{
-			if (i < pixelLengths.size() && g_largestCopiedStrSinceResize < pixelLengths[i])
-				g_largestCopiedStrSinceResize = TranslationEntry(lines[i], pixelLengths[i]);
-		}
-
-		tStr = utf82sjis(tStr);
-
-		uint8_t* pBuffer = new uint8_t[tStr.size() + 1]();
-		memcpy(pBuffer, tStr.c_str(), tStr.size());
-		result = Real_CopyFunc(a1, pBuffer, a3);
-		delete[] pBuffer;
-	}
-	else
-		result = Real_CopyFunc(a1, a2, a3);
-
-	return result;
+	return Real_CopyFunc(a1, a2, a3);
 }
 
 int WINAPI Mine_DrawFormatVStringToHandle(int x, int y, unsigned int Color, int FontHandle, const char* FormatString, ...)
 {
-	int result = -1;
+	stats::HookScope scope(stats::Hook::DrawFormatVStringToHandle);
+	epoch::ReadGuard guard;
 
 	char buffer[4096];
 	va_list args;
 	va_start(args, FormatString);
-	vsnprintf(buffer, sizeof(buffer), FormatString, args);
-	va_end(args);
-
-	std::string utf8String = sjis2utf8(buffer);
-
-	g_largestCopiedStrSinceResize.clear();
 
-	// Check if this string exists in the translations
-	if (g_translations.contains(utf8String))
-	{
-		nlohmann::json entry;
-
-		if (!getEntryAndCheck(utf8String, entry))
-			return Real_DrawFormatVStringToHandle(x, y, Color, FontHandle, buffer);
-
-		const std::string tStr = utf82sjis(entry["text"]);
-
-		result = Real_DrawFormatVStringToHandle(x, y, Color, FontHandle, tStr.c_str());
-	}
-	else
-		result = Real_DrawFormatVStringToHandle(x, y, Color, FontHandle, buffer);
+	const char* pStr = drawString(currentTranslations(), FormatString, args, buffer, sizeof(buffer), scope, g_largestCopiedStrSinceResize);
+	va_end(args);
 
-	return result;
+	return Real_DrawFormatVStringToHandle(x, y, Color, FontHandle, pStr);
 }
 
 //
@@ -336,10 +294,46 @@ VOID DetDetach(PVOID* ppbReal, PVOID pbMine, const char* psz)
 #endif
 }
 
+//
+// Every thread but the calling one may be running game code while the detours are written.
+// The transaction suspends them and moves their instruction pointers out of the overwritten bytes.
+//
+std::vector<HANDLE> OpenOtherThreads()
+{
+	std::vector<HANDLE> threads;
+
+	HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+	if (hSnapshot == INVALID_HANDLE_VALUE)
+		return threads;
+
+	const DWORD processId       = GetCurrentProcessId();
+	const DWORD currentThreadId = GetCurrentThreadId();
+
+	THREADENTRY32 entry = {};
+	entry.dwSize        = sizeof(entry);
+
+	for (BOOL found = Thread32First(hSnapshot, &entry); found; found = Thread32Next(hSnapshot, &entry))
+	{
+		if (entry.th32OwnerProcessID != processId || entry.th32ThreadID == currentThreadId)
+			continue;
+
+		HANDLE hThread = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT, FALSE, entry.th32ThreadID);
+		if (hThread != nullptr)
+			threads.push_back(hThread);
+	}
+
+	CloseHandle(hSnapshot);
+	return threads;
+}
+
 LONG AttachDetours(VOID)
 {
+	const std::vector<HANDLE> threads = OpenOtherThreads();
+
 	DetourTransactionBegin();
-	DetourUpdateThread(GetCurrentThread());
+
+	for (HANDLE hThread : threads)
+		DetourUpdateThread(hThread);
 
 	ATTACH(DrawFormatVStringToHandle);
 	ATTACH(CopyFunc);
@@ -347,7 +341,13 @@ LONG AttachDetours(VOID)
 	ATTACH(SetWindowTitle);
 	ATTACH(CopyEnemyNameFunc);
 
-	return DetourTransactionCommit();
+	const LONG error = DetourTransactionCommit();
+
+	// The handles have to stay open until the transaction is committed
+	for (HANDLE hThread : threads)
+		CloseHandle(hThread);
+
+	return error;
 }
 
 LONG DetachDetours(VOID)
@@ -382,6 +382,9 @@ BOOL ThreadAttach([[maybe_unused]] HMODULE hDll)
 
 BOOL ThreadDetach([[maybe_unused]] HMODULE hDll)
 {
+	// Threads come and go while the game runs, their epoch records are reused by new threads
+	epoch::unregisterThread();
+
 #if INCLUDE_DEBUG_LOGGING
 	logging::ThreadDetach();
 #endif
@@ -390,26 +393,447 @@ BOOL ThreadDetach([[maybe_unused]] HMODULE hDll)
 }
 
 template<typename T>
-void SetupHook(T& realFuncPtr, const std::vector<BYTE>& funcBytes, const char* funcName)
+void SetupHook(T& realFuncPtr, const SignatureScanner& scanner, const uint32_t signatureId, const char* funcName)
 {
-	realFuncPtr        = nullptr;
-	uintptr_t funcAddr = findFunction(funcBytes);
+	realFuncPtr = nullptr;
 
-	if (funcAddr == ~0)
+	if (scanner.result(signatureId) == SignatureScanner::NOT_FOUND)
 	{
 #if INCLUDE_DEBUG_LOGGING
 		Syelog(SYELOG_SEVERITY_FATAL, "### Error: Unable to find the %s function\n", funcName);
 #endif
 		return;
 	}
-	else
+
+	const uintptr_t funcAddr = reinterpret_cast<uintptr_t>(GetModuleHandleW(nullptr)) + scanner.result(signatureId);
+
+#if INCLUDE_DEBUG_LOGGING
+	Syelog(SYELOG_SEVERITY_INFORMATION, "### Found %s function at address: 0x%p\n", funcName, reinterpret_cast<void*>(funcAddr));
+#endif
+
+	realFuncPtr = reinterpret_cast<T>(funcAddr);
+}
+
+//
+// Signatures of all hooked functions and the scanner resolving them
+//
+struct HookSignatures
+{
+	HookSignatures()
 	{
+		drawFormatVStringId = scanner.add(DRAW_FORMAT_VSTRING_FUNC);
+		copyId              = scanner.add(COPY_FUNC);
+		getWidthId          = scanner.add(GET_DRAW_FORMAT_STRING_WIDTH_FUNC);
+		setWindowTitleId    = scanner.add(SET_WINDOW_TITLE_FUNC);
+		copyEnemyNameId     = scanner.add(COPY_ENEMY_NAME_FUNC);
+	}
+
+	SignatureScanner scanner;
+
+	uint32_t drawFormatVStringId = 0;
+	uint32_t copyId              = 0;
+	uint32_t getWidthId          = 0;
+	uint32_t setWindowTitleId    = 0;
+	uint32_t copyEnemyNameId     = 0;
+};
+
+//
+// Code of the running game build
+//
+struct GameImage
+{
+	const BYTE* pBase = nullptr;
+	std::vector<ModuleSection> sections;
+	size_t codeSize = 0;
+	ImageIdentity identity;
+};
+
+//
+// Identity of the running game build, read from the headers of the executable file.
+// Only the first few KiB are read, the code itself is checked by matching the signatures at the cached RVAs.
+//
+ImageIdentity GetImageIdentity()
+{
+	ImageIdentity identity;
+	WCHAR wzPath[MAX_PATH];
+
+	const DWORD length = GetModuleFileNameW(nullptr, wzPath, ARRAYSIZE(wzPath));
+	if (length == 0 || length == ARRAYSIZE(wzPath))
+		return identity;
+
+	const HANDLE hFile = CreateFileW(wzPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return identity;
+
+	std::vector<uint8_t> header(IMAGE_HEADER_READ_SIZE);
+	LARGE_INTEGER fileSize = {};
+	DWORD bytesRead        = 0;
+
+	const bool read = GetFileSizeEx(hFile, &fileSize) && ReadFile(hFile, header.data(), static_cast<DWORD>(header.size()), &bytesRead, nullptr);
+	CloseHandle(hFile);
+
+	if (!read || !readImageIdentity(header.data(), bytesRead, static_cast<uint64_t>(fileSize.QuadPart), identity))
+		return ImageIdentity();
+
+	return identity;
+}
+
+GameImage GetGameImage()
+{
+	const HMODULE hModule = GetModuleHandleW(nullptr);
+	GameImage image;
+
+	image.pBase    = reinterpret_cast<const BYTE*>(hModule);
+	image.sections = getExecutableSections(hModule);
+	image.identity = GetImageIdentity();
+
+	for (const ModuleSection& section : image.sections)
+		image.codeSize += section.size;
+
+	return image;
+}
+
+//
+// Check the signatures at the RVAs cached for this build, all of them have to match
+//
+bool ApplyCachedSignatures(SignatureScanner& scanner, const GameImage& image, const std::vector<uint32_t>& rvas)
+{
+	if (rvas.size() != scanner.size())
+		return false;
+
+	for (uint32_t id = 0; id < rvas.size(); id++)
+	{
+		bool accepted = false;
+
+		for (const ModuleSection& section : image.sections)
+		{
+			const size_t sectionRva = static_cast<size_t>(section.pStart - image.pBase);
+
+			if (rvas[id] >= sectionRva && rvas[id] < sectionRva + section.size)
+			{
+				accepted = scanner.accept(id, section.pStart, section.size, rvas[id] - sectionRva, sectionRva);
+				break;
+			}
+		}
+
+		if (!accepted)
+			return false;
+	}
+
+	return scanner.allFound();
+}
+
+//
+// Reuse the RVAs of the last run if the game build did not change
+//
+bool ResolveCachedSignatures(SignatureScanner& scanner, const GameImage& image)
+{
+	std::vector<uint32_t> rvas;
+
+	if (!loadSignatureCache(SIGNATURE_CACHE_FILE, image.identity, rvas))
+		return false;
+
+	if (!ApplyCachedSignatures(scanner, image, rvas))
+	{
+		scanner.reset();
+		return false;
+	}
+
 #if INCLUDE_DEBUG_LOGGING
-		Syelog(SYELOG_SEVERITY_INFORMATION, "### Found %s function at address: 0x%p\n", funcName, reinterpret_cast<void*>(funcAddr));
+	Syelog(SYELOG_SEVERITY_INFORMATION, "### Using cached function addresses from %s\n", SIGNATURE_CACHE_FILE.c_str());
 #endif
+
+	return true;
+}
+
+//
+// Scan all executable sections for the signatures and remember the results for the next run.
+// Results are relative to the module base.
+//
+void ScanSignatures(SignatureScanner& scanner, const GameImage& image, const uint32_t threadCount)
+{
+	for (const ModuleSection& section : image.sections)
+	{
+		scanner.scanParallel(section.pStart, section.size, static_cast<size_t>(section.pStart - image.pBase), threadCount);
+
+		if (scanner.allFound())
+			break;
 	}
 
-	realFuncPtr = reinterpret_cast<T>(funcAddr);
+	// Only complete results are worth keeping, a partial match is rescanned on the next start anyway
+	if (!scanner.allFound())
+		return;
+
+	std::vector<uint32_t> rvas(scanner.size());
+	for (uint32_t id = 0; id < scanner.size(); id++)
+		rvas[id] = static_cast<uint32_t>(scanner.result(id));
+
+	if (!saveSignatureCache(SIGNATURE_CACHE_FILE, image.identity, rvas))
+	{
+#if INCLUDE_DEBUG_LOGGING
+		Syelog(SYELOG_SEVERITY_WARNING, "### Warning: Could not write %s\n", SIGNATURE_CACHE_FILE.c_str());
+#endif
+	}
+}
+
+void InstallHooks(const HookSignatures& signatures)
+{
+	const SignatureScanner& scanner = signatures.scanner;
+
+	SetupHook(Real_DrawFormatVStringToHandle, scanner, signatures.drawFormatVStringId, "DrawFormatVStringToHandle");
+	SetupHook(Real_CopyFunc, scanner, signatures.copyId, "CopyFunc");
+	SetupHook(Real_GetDrawFormatStringWidth, scanner, signatures.getWidthId, "GetDrawFormatStringWidth");
+	SetupHook(Real_SetWindowTitle, scanner, signatures.setWindowTitleId, "SetWindowTitle");
+	SetupHook(Real_CopyEnemyNameFunc, scanner, signatures.copyEnemyNameId, "CopyEnemyNameFunc");
+
+	LONG error = AttachDetours();
+
+#if INCLUDE_DEBUG_LOGGING
+	if (error != NO_ERROR)
+		Syelog(SYELOG_SEVERITY_FATAL, "### Error attaching detours: %d\n", error);
+
+	Syelog(SYELOG_SEVERITY_NOTICE, "### Attached.\n");
+#else
+	(void)error;
+#endif
+}
+
+//
+// State handed to the thread that scans large executables
+//
+struct DeferredHookSetup
+{
+	HookSignatures signatures;
+	GameImage image;
+};
+
+//
+// Runs outside of the loader lock, so the scan can use worker threads
+//
+DWORD WINAPI HookSetupThread(LPVOID pParam)
+{
+	std::unique_ptr<DeferredHookSetup> pSetup(static_cast<DeferredHookSetup*>(pParam));
+
+	const uint32_t threadCount = (std::max)(1u, (std::min)(std::thread::hardware_concurrency(), MAX_SCAN_THREADS));
+
+	ScanSignatures(pSetup->signatures.scanner, pSetup->image, threadCount);
+	InstallHooks(pSetup->signatures);
+	return 0;
+}
+
+//
+// Hooks are installed right away if the addresses are cached or the executable is small.
+// Otherwise the scan is moved to a separate thread, creating and waiting for worker threads is not possible under the loader lock.
+//
+void SetupHooks()
+{
+	std::unique_ptr<DeferredHookSetup> pSetup = std::make_unique<DeferredHookSetup>();
+	pSetup->image                             = GetGameImage();
+
+	SignatureScanner& scanner = pSetup->signatures.scanner;
+
+	if (ResolveCachedSignatures(scanner, pSetup->image))
+	{
+		InstallHooks(pSetup->signatures);
+		return;
+	}
+
+	if (pSetup->image.codeSize >= PARALLEL_SCAN_THRESHOLD)
+	{
+		HANDLE hThread = CreateThread(nullptr, 0, HookSetupThread, pSetup.get(), 0, nullptr);
+
+		if (hThread != nullptr)
+		{
+#if INCLUDE_DEBUG_LOGGING
+			Syelog(SYELOG_SEVERITY_INFORMATION, "### Scanning %u bytes of code on a separate thread\n", static_cast<unsigned>(pSetup->image.codeSize));
+#endif
+
+			pSetup.release();
+			CloseHandle(hThread);
+			return;
+		}
+	}
+
+	ScanSignatures(scanner, pSetup->image, 1);
+	InstallHooks(pSetup->signatures);
+}
+
+#if INCLUDE_HOOK_STATS
+void DumpHookStats()
+{
+	const std::string report = stats::report();
+
+	FILE* pFile = fopen(HOOK_STATS_FILE.c_str(), "w");
+	if (pFile != nullptr)
+	{
+		fwrite(report.data(), 1, report.size(), pFile);
+		fclose(pFile);
+	}
+
+#if INCLUDE_DEBUG_LOGGING
+	Syelog(SYELOG_SEVERITY_INFORMATION, "### Wrote hook statistics to %s\n", HOOK_STATS_FILE.c_str());
+#endif
+}
+
+//
+// Polls the hotkey instead of registering it, the hook DLL does not own a message loop
+//
+DWORD WINAPI HookStatsHotkeyThread(LPVOID pParam)
+{
+	HANDLE hStopEvent = static_cast<HANDLE>(pParam);
+	bool wasDown      = false;
+
+	while (WaitForSingleObject(hStopEvent, 250) == WAIT_TIMEOUT)
+	{
+		const bool isDown = (GetAsyncKeyState(HOOK_STATS_HOTKEY) & 0x8000) != 0;
+
+		if (isDown && !wasDown)
+			DumpHookStats();
+
+		wasDown = isDown;
+	}
+
+	CloseHandle(hStopEvent);
+	return 0;
+}
+#endif
+
+bool LoadTranslationPack(TranslationTable& table)
+{
+	if (!table.map(TRANSLATIONS_PACK_FILE))
+		return false;
+
+#if INCLUDE_DEBUG_LOGGING
+	Syelog(SYELOG_SEVERITY_INFORMATION, "### Mapped %u translations from %s.\n", static_cast<unsigned>(table.size()), TRANSLATIONS_PACK_FILE.c_str());
+#endif
+
+	return true;
+}
+
+bool LoadTranslationsJson(TranslationTable& table)
+{
+	try
+	{
+		TranslationTableBuilder builder;
+		std::vector<TranslationSchemaError> errors;
+
+		// Optional, lets tr.json leave out the pixel lengths
+		FontMetrics font;
+		font.open(FONT_FILE, FONT_SIZE);
+
+		if (!loadTranslationsJson(TRANSLATIONS_FILE, builder, &errors, font.isOpen() ? &font : nullptr))
+		{
+#if INCLUDE_DEBUG_LOGGING
+			Syelog(SYELOG_SEVERITY_WARNING, "### Warning: Could not open %s\n", TRANSLATIONS_FILE.c_str());
+#endif
+			return false;
+		}
+
+#if INCLUDE_DEBUG_LOGGING
+		for (const TranslationSchemaError& error : errors)
+			Syelog(SYELOG_SEVERITY_WARNING, "### Warning: Skipped entry \"%s\" at byte %u of %s: %s\n", error.key.c_str(), static_cast<unsigned>(error.offset), TRANSLATIONS_FILE.c_str(), error.message.c_str());
+#endif
+
+		if (!table.load(builder.build()))
+			return false;
+
+#if INCLUDE_DEBUG_LOGGING
+		Syelog(SYELOG_SEVERITY_INFORMATION, "### Loaded %u translations.\n", static_cast<unsigned>(table.size()));
+#endif
+
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		(void)e;
+
+#if INCLUDE_DEBUG_LOGGING
+		Syelog(SYELOG_SEVERITY_ERROR, "### Error: Could not load %s: %s\n", TRANSLATIONS_FILE.c_str(), e.what());
+#endif
+	}
+
+	return false;
+}
+
+//
+// Prefer the compiled pack, it is mapped without any parsing. Fall back to parsing tr.json.
+//
+bool LoadTranslations(TranslationTable& table)
+{
+	return LoadTranslationPack(table) || LoadTranslationsJson(table);
+}
+
+//
+// Make a snapshot visible to the hooks and free the previous one once no hook can still be using it
+//
+void PublishTranslations(std::unique_ptr<TranslationSnapshot> pSnapshot)
+{
+	std::lock_guard<std::mutex> lock(g_publishMutex);
+
+	pSnapshot->generation = ++g_snapshotGeneration;
+
+	// Cached lookups are translation indices, so every table gets its own cache
+	if (g_pRData != nullptr)
+		pSnapshot->rdataCache.init(g_pRData, g_rdataSize);
+
+	TranslationSnapshot* pOld = g_pTranslations.exchange(pSnapshot.release());
+
+	// A hook could be waiting for the first table while holding a read guard
+	SetEvent(g_hTranslationsReady);
+
+	if (pOld != nullptr)
+	{
+		epoch::synchronize();
+		delete pOld;
+	}
+}
+
+//
+// Runs on the watcher thread, a table that fails to load keeps the current one in place
+//
+void ReloadTranslations(const std::string& fileName)
+{
+	std::unique_ptr<TranslationSnapshot> pSnapshot = std::make_unique<TranslationSnapshot>();
+
+	const bool loaded = (fileName == TRANSLATIONS_PACK_FILE) ? LoadTranslationPack(pSnapshot->table) : LoadTranslationsJson(pSnapshot->table);
+
+	if (!loaded)
+	{
+#if INCLUDE_DEBUG_LOGGING
+		Syelog(SYELOG_SEVERITY_WARNING, "### Warning: Reloading %s failed, keeping the current translations\n", fileName.c_str());
+#endif
+		return;
+	}
+
+	PublishTranslations(std::move(pSnapshot));
+
+#if INCLUDE_DEBUG_LOGGING
+	Syelog(SYELOG_SEVERITY_INFORMATION, "### Reloaded translations from %s\n", fileName.c_str());
+#endif
+}
+
+//
+// Load the translations and publish them to the hooks
+//
+DWORD WINAPI TranslationLoaderThread(LPVOID)
+{
+	std::unique_ptr<TranslationSnapshot> pSnapshot = std::make_unique<TranslationSnapshot>();
+
+	if (LoadTranslations(pSnapshot->table))
+		PublishTranslations(std::move(pSnapshot));
+
+#if INCLUDE_DEBUG_LOGGING
+	LARGE_INTEGER now;
+	LARGE_INTEGER frequency;
+	QueryPerformanceCounter(&now);
+	QueryPerformanceFrequency(&frequency);
+
+	const double elapsedMs = static_cast<double>(now.QuadPart - g_attachTime.QuadPart) * 1000.0 / static_cast<double>(frequency.QuadPart);
+	Syelog(SYELOG_SEVERITY_INFORMATION, "### Translations ready %u ms after attach\n", static_cast<unsigned>(elapsedMs));
+#endif
+
+	SetEvent(g_hTranslationsReady);
+	return 0;
 }
 
 BOOL ProcessAttach(HMODULE hDll)
@@ -424,37 +848,62 @@ BOOL ProcessAttach(HMODULE hDll)
 	Syelog(SYELOG_SEVERITY_INFORMATION, "### %ls\n", wzExeName);
 
 	Syelog(SYELOG_SEVERITY_INFORMATION, "### Loading translations...\n");
+
+	QueryPerformanceCounter(&g_attachTime);
 #endif
 
-	std::ifstream i(TRANSLATIONS_FILE);
-	if (i.is_open())
-	{
-		i >> g_translations;
+	char waitMs[16];
+	if (GetEnvironmentVariableA(TRANSLATIONS_WAIT_VARIABLE, waitMs, sizeof(waitMs)) > 0)
+		g_translationsWaitMs = static_cast<DWORD>(strtoul(waitMs, nullptr, 10));
 
+	// Needed by every published snapshot, so it has to be known before the loader thread starts
+	if (getModuleSection(GetModuleHandleW(nullptr), ".rdata", g_pRData, g_rdataSize))
+	{
 #if INCLUDE_DEBUG_LOGGING
-		Syelog(SYELOG_SEVERITY_INFORMATION, "### Loaded %d translations.\n", g_translations.size());
+		Syelog(SYELOG_SEVERITY_INFORMATION, "### Caching lookups for .rdata strings at 0x%p (%u bytes)\n", g_pRData, static_cast<unsigned>(g_rdataSize));
 #endif
 	}
+
+	// Parsing tr.json under the loader lock would delay the game window, the hooks pass everything through until the table is published
+	g_hTranslationsReady = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+	HANDLE hLoaderThread = CreateThread(nullptr, 0, TranslationLoaderThread, nullptr, 0, nullptr);
+	if (hLoaderThread != nullptr)
+		CloseHandle(hLoaderThread);
 	else
+		TranslationLoaderThread(nullptr);
+
+	char hotReload[4];
+	if (GetEnvironmentVariableA(HOT_RELOAD_VARIABLE, hotReload, sizeof(hotReload)) > 0 && strcmp(hotReload, "0") != 0)
 	{
+		if (g_translationWatcher.start(".", { TRANSLATIONS_FILE, TRANSLATIONS_PACK_FILE }, ReloadTranslations))
+		{
+			// The watcher thread may be inside ReloadTranslations at any time, so the DLL must stay loaded until the process exits
+			HMODULE hPinned = nullptr;
+			GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN, reinterpret_cast<LPCWSTR>(hDll), &hPinned);
+
 #if INCLUDE_DEBUG_LOGGING
-		Syelog(SYELOG_SEVERITY_WARNING, "### Warning: Could not open %s\n", TRANSLATIONS_FILE.c_str());
+			Syelog(SYELOG_SEVERITY_INFORMATION, "### Watching %s and %s for changes\n", TRANSLATIONS_FILE.c_str(), TRANSLATIONS_PACK_FILE.c_str());
 #endif
+		}
 	}
 
-	SetupHook(Real_DrawFormatVStringToHandle, DRAW_FORMAT_VSTRING_FUNC, "DrawFormatVStringToHandle");
-	SetupHook(Real_CopyFunc, COPY_FUNC, "CopyFunc");
-	SetupHook(Real_GetDrawFormatStringWidth, GET_DRAW_FORMAT_STRING_WIDTH_FUNC, "GetDrawFormatStringWidth");
-	SetupHook(Real_SetWindowTitle, SET_WINDOW_TITLE_FUNC, "SetWindowTitle");
-	SetupHook(Real_CopyEnemyNameFunc, COPY_ENEMY_NAME_FUNC, "CopyEnemyNameFunc");
+	SetupHooks();
 
-	LONG error = AttachDetours();
-
-#if INCLUDE_DEBUG_LOGGING
-	if (error != NO_ERROR)
-		Syelog(SYELOG_SEVERITY_FATAL, "### Error attaching detours: %d\n", error);
-
-	Syelog(SYELOG_SEVERITY_NOTICE, "### Attached.\n");
+#if INCLUDE_HOOK_STATS
+	// The thread only starts running once the loader lock is released
+	g_hStatsStopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	if (g_hStatsStopEvent != nullptr)
+	{
+		HANDLE hThread = CreateThread(nullptr, 0, HookStatsHotkeyThread, g_hStatsStopEvent, 0, nullptr);
+		if (hThread != nullptr)
+			CloseHandle(hThread);
+		else
+		{
+			CloseHandle(g_hStatsStopEvent);
+			g_hStatsStopEvent = nullptr;
+		}
+	}
 #endif
 
 	ThreadAttach(hDll);
@@ -472,6 +921,17 @@ BOOL ProcessDetach(HMODULE hDll)
 
 	LONG error = DetachDetours();
 
+	// The DLL is pinned while the watcher runs, so this only happens at process exit after the watcher thread was terminated and the join returns at once
+	g_translationWatcher.stop();
+
+#if INCLUDE_HOOK_STATS
+	// The hotkey thread closes the event itself, waiting for it here would block on the loader lock
+	if (g_hStatsStopEvent != nullptr)
+		SetEvent(g_hStatsStopEvent);
+
+	DumpHookStats();
+#endif
+
 #if INCLUDE_DEBUG_LOGGING
 	if (error != NO_ERROR)
 		Syelog(SYELOG_SEVERITY_FATAL, "### Error detaching detours: %d\n", error);
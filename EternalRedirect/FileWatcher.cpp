@@ -0,0 +1,288 @@
+/*
+ *  File: FileWatcher.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "FileWatcher.hpp"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Time without further changes before the collected changes are reported
+static const int DEBOUNCE_MS = 200;
+
+struct FileWatcher::State
+{
+	std::vector<std::string> fileNames;
+	Callback callback;
+
+#ifdef _WIN32
+	HANDLE hDirectory = INVALID_HANDLE_VALUE;
+	HANDLE hStopEvent = nullptr;
+	HANDLE hReadEvent = nullptr;
+
+	~State()
+	{
+		if (hDirectory != INVALID_HANDLE_VALUE)
+			CloseHandle(hDirectory);
+		if (hStopEvent != nullptr)
+			CloseHandle(hStopEvent);
+		if (hReadEvent != nullptr)
+			CloseHandle(hReadEvent);
+	}
+#else
+	int inotifyFd = -1;
+	int stopPipe[2] = { -1, -1 };
+
+	~State()
+	{
+		if (inotifyFd >= 0)
+			close(inotifyFd);
+		if (stopPipe[0] >= 0)
+			close(stopPipe[0]);
+		if (stopPipe[1] >= 0)
+			close(stopPipe[1]);
+	}
+#endif
+
+	bool isWatched(const std::string& fileName) const
+	{
+		return std::find(fileNames.begin(), fileNames.end(), fileName) != fileNames.end();
+	}
+
+	void report(std::set<std::string>& changed) const
+	{
+		for (const std::string& fileName : changed)
+			callback(fileName);
+
+		changed.clear();
+	}
+};
+
+FileWatcher::~FileWatcher()
+{
+	stop();
+}
+
+//
+// A callback may stop the watcher from its own thread, which can not join itself and finishes on its own
+//
+void FileWatcher::join()
+{
+	if (!m_thread.joinable())
+		return;
+
+	if (m_thread.get_id() == std::this_thread::get_id())
+		m_thread.detach();
+	else
+		m_thread.join();
+}
+
+#ifdef _WIN32
+bool FileWatcher::start(const std::string& directory, const std::vector<std::string>& fileNames, Callback callback)
+{
+	stop();
+
+	std::shared_ptr<State> pState = std::make_shared<State>();
+	pState->fileNames             = fileNames;
+	pState->callback              = std::move(callback);
+
+	pState->hDirectory = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	pState->hStopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	pState->hReadEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+	if (pState->hDirectory == INVALID_HANDLE_VALUE || pState->hStopEvent == nullptr || pState->hReadEvent == nullptr)
+		return false;
+
+	m_thread = std::thread(run, pState);
+
+	m_pState = std::move(pState);
+	return true;
+}
+
+void FileWatcher::run(std::shared_ptr<State> pState)
+{
+	OVERLAPPED overlapped = {};
+	overlapped.hEvent     = pState->hReadEvent;
+
+	alignas(DWORD) BYTE buffer[8192];
+	std::set<std::string> changed;
+	bool readPending = false;
+
+	for (;;)
+	{
+		if (!readPending)
+		{
+			ResetEvent(pState->hReadEvent);
+
+			if (!ReadDirectoryChangesW(pState->hDirectory, buffer, sizeof(buffer), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr, &overlapped, nullptr))
+				break;
+
+			readPending = true;
+		}
+
+		const HANDLE handles[] = { pState->hStopEvent, pState->hReadEvent };
+		const DWORD result     = WaitForMultipleObjects(2, handles, FALSE, changed.empty() ? INFINITE : DEBOUNCE_MS);
+
+		if (result == WAIT_TIMEOUT)
+		{
+			pState->report(changed);
+			continue;
+		}
+
+		if (result != WAIT_OBJECT_0 + 1)
+		{
+			// The buffer lives on this stack, so the cancelled read has to complete before returning
+			DWORD bytes = 0;
+			CancelIoEx(pState->hDirectory, &overlapped);
+			GetOverlappedResult(pState->hDirectory, &overlapped, &bytes, TRUE);
+			break;
+		}
+
+		readPending = false;
+
+		DWORD bytes = 0;
+		if (!GetOverlappedResult(pState->hDirectory, &overlapped, &bytes, FALSE))
+			break;
+
+		// An overflowed buffer reports no entries, so treat it as a change of every file
+		if (bytes == 0)
+		{
+			changed.insert(pState->fileNames.begin(), pState->fileNames.end());
+			continue;
+		}
+
+		const BYTE* pEntry = buffer;
+
+		for (;;)
+		{
+			const FILE_NOTIFY_INFORMATION* pInfo = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(pEntry);
+			const int nameLength                 = static_cast<int>(pInfo->FileNameLength / sizeof(WCHAR));
+
+			const int length = WideCharToMultiByte(CP_UTF8, 0, pInfo->FileName, nameLength, nullptr, 0, nullptr, nullptr);
+			std::string fileName(static_cast<size_t>(length), '\0');
+			WideCharToMultiByte(CP_UTF8, 0, pInfo->FileName, nameLength, &fileName[0], length, nullptr, nullptr);
+
+			if (pState->isWatched(fileName))
+				changed.insert(fileName);
+
+			if (pInfo->NextEntryOffset == 0)
+				break;
+
+			pEntry += pInfo->NextEntryOffset;
+		}
+	}
+}
+
+void FileWatcher::stop()
+{
+	if (m_pState)
+		SetEvent(m_pState->hStopEvent);
+
+	m_pState.reset();
+	join();
+}
+#else
+bool FileWatcher::start(const std::string& directory, const std::vector<std::string>& fileNames, Callback callback)
+{
+	stop();
+
+	std::shared_ptr<State> pState = std::make_shared<State>();
+	pState->fileNames             = fileNames;
+	pState->callback              = std::move(callback);
+
+	pState->inotifyFd = inotify_init1(IN_CLOEXEC);
+	if (pState->inotifyFd < 0 || pipe(pState->stopPipe) != 0)
+		return false;
+
+	if (inotify_add_watch(pState->inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+		return false;
+
+	m_thread = std::thread(run, pState);
+
+	m_pState = std::move(pState);
+	return true;
+}
+
+void FileWatcher::run(std::shared_ptr<State> pState)
+{
+	alignas(inotify_event) char buffer[8192];
+	std::set<std::string> changed;
+
+	for (;;)
+	{
+		pollfd fds[2] = { { pState->stopPipe[0], POLLIN, 0 }, { pState->inotifyFd, POLLIN, 0 } };
+
+		const int result = poll(fds, 2, changed.empty() ? -1 : DEBOUNCE_MS);
+
+		if (result == 0)
+		{
+			pState->report(changed);
+			continue;
+		}
+
+		if (result < 0 && errno == EINTR)
+			continue;
+
+		if (result < 0 || (fds[0].revents & POLLIN) != 0)
+			break;
+
+		const ssize_t bytes = read(pState->inotifyFd, buffer, sizeof(buffer));
+		if (bytes <= 0)
+			break;
+
+		for (ssize_t offset = 0; offset < bytes;)
+		{
+			const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(buffer + offset);
+
+			if (pEvent->len > 0 && pState->isWatched(pEvent->name))
+				changed.insert(pEvent->name);
+
+			offset += static_cast<ssize_t>(sizeof(inotify_event) + pEvent->len);
+		}
+	}
+}
+
+void FileWatcher::stop()
+{
+	if (m_pState)
+	{
+		const char signal = 1;
+		(void)!write(m_pState->stopPipe[1], &signal, 1);
+	}
+
+	m_pState.reset();
+	join();
+}
+#endif
@@ -0,0 +1,66 @@
+/*
+ *  File: FileWatcher.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// Watches a directory for changes to a set of files on a background thread.
+// Bursts of changes, like an editor saving a file in several steps, are reported once after a short quiet period.
+//
+class FileWatcher
+{
+public:
+	using Callback = std::function<void(const std::string& fileName)>;
+
+	FileWatcher() = default;
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&)            = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// The callback runs on the watcher thread
+	bool start(const std::string& directory, const std::vector<std::string>& fileNames, Callback callback);
+
+	// Signals the thread and waits until it left the callback.
+	// The thread exit needs the loader lock, so a DLL must not call this from DllMain while the thread can still be running.
+	void stop();
+
+private:
+	struct State;
+
+	static void run(std::shared_ptr<State> pState);
+
+	void join();
+
+	std::shared_ptr<State> m_pState;
+	std::thread m_thread;
+};
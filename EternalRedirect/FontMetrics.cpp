@@ -0,0 +1,767 @@
+/*
+ *  File: FontMetrics.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "FontMetrics.hpp"
+
+#include <algorithm>
+
+static constexpr uint32_t makeTag(const char* pTag)
+{
+	return (static_cast<uint32_t>(static_cast<uint8_t>(pTag[0])) << 24) | (static_cast<uint32_t>(static_cast<uint8_t>(pTag[1])) << 16)
+		   | (static_cast<uint32_t>(static_cast<uint8_t>(pTag[2])) << 8) | static_cast<uint32_t>(static_cast<uint8_t>(pTag[3]));
+}
+
+static constexpr uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// PIL and FreeType shrink kern table values below this size, so rounding does not make them too large
+static constexpr int32_t KERNING_SCALE_PPEM = 25;
+
+//////////////////////////////////////////////////////////////////////////////
+// Fixed point helpers, identical to the FreeType ones so rounding matches exactly
+//
+
+static int32_t mulFix(const int64_t a, const int64_t b)
+{
+	const int64_t product = ((a < 0 ? -a : a) * (b < 0 ? -b : b) + 0x8000) >> 16;
+	return static_cast<int32_t>(((a < 0) != (b < 0)) ? -product : product);
+}
+
+static int32_t divFix(const int64_t a, const int64_t b)
+{
+	const int64_t absB     = b < 0 ? -b : b;
+	const int64_t quotient = (((a < 0 ? -a : a) << 16) + (absB >> 1)) / absB;
+	return static_cast<int32_t>(((a < 0) != (b < 0)) ? -quotient : quotient);
+}
+
+static int32_t mulDiv(const int64_t a, const int64_t b, const int64_t c)
+{
+	const int64_t result = ((a < 0 ? -a : a) * (b < 0 ? -b : b) + c / 2) / c;
+	return static_cast<int32_t>(((a < 0) != (b < 0)) ? -result : result);
+}
+
+static int32_t pixFloor(const int32_t x)
+{
+	return x & ~63;
+}
+
+static int32_t pixCeil(const int32_t x)
+{
+	return (x + 63) & ~63;
+}
+
+static int32_t pixRound(const int32_t x)
+{
+	return (x + 32) & ~63;
+}
+
+// 26.6 to whole pixels, the PIXEL macro used by PIL
+static int32_t toPixels(const int64_t x)
+{
+	return static_cast<int32_t>((x + 32) >> 6);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// OpenType layout helpers
+//
+
+// Index of the glyph in a coverage table or -1 if it is not covered
+static int32_t coverageIndex(const FontTable& table, const size_t offset, const uint16_t glyph)
+{
+	const uint16_t format = table.u16(offset);
+	const uint16_t count  = table.u16(offset + 2);
+
+	if (format == 1)
+	{
+		uint32_t low  = 0;
+		uint32_t high = count;
+
+		while (low < high)
+		{
+			const uint32_t mid   = (low + high) / 2;
+			const uint16_t value = table.u16(offset + 4 + mid * 2);
+
+			if (value == glyph)
+				return static_cast<int32_t>(mid);
+
+			if (value < glyph)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+	}
+	else if (format == 2)
+	{
+		uint32_t low  = 0;
+		uint32_t high = count;
+
+		while (low < high)
+		{
+			const uint32_t mid   = (low + high) / 2;
+			const size_t record  = offset + 4 + mid * 6;
+			const uint16_t start = table.u16(record);
+			const uint16_t end   = table.u16(record + 2);
+
+			if (glyph < start)
+				high = mid;
+			else if (glyph > end)
+				low = mid + 1;
+			else
+				return table.u16(record + 4) + (glyph - start);
+		}
+	}
+
+	return -1;
+}
+
+static uint16_t glyphClass(const FontTable& table, const size_t offset, const uint16_t glyph)
+{
+	const uint16_t format = table.u16(offset);
+
+	if (format == 1)
+	{
+		const uint16_t startGlyph = table.u16(offset + 2);
+		const uint16_t count      = table.u16(offset + 4);
+
+		if (glyph >= startGlyph && glyph - startGlyph < count)
+			return table.u16(offset + 6 + (glyph - startGlyph) * 2);
+	}
+	else if (format == 2)
+	{
+		uint32_t low  = 0;
+		uint32_t high = table.u16(offset + 2);
+
+		while (low < high)
+		{
+			const uint32_t mid   = (low + high) / 2;
+			const size_t record  = offset + 4 + mid * 6;
+			const uint16_t start = table.u16(record);
+			const uint16_t end   = table.u16(record + 2);
+
+			if (glyph < start)
+				high = mid;
+			else if (glyph > end)
+				low = mid + 1;
+			else
+				return table.u16(record + 4);
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t valueRecordSize(const uint16_t valueFormat)
+{
+	uint32_t size = 0;
+	for (uint16_t bits = valueFormat & 0xFF; bits != 0; bits &= bits - 1)
+		size += 2;
+
+	return size;
+}
+
+// Reads the XAdvance of a value record, XPlacement and YPlacement come before it
+static int32_t valueRecordAdvance(const FontTable& table, const size_t offset, const uint16_t valueFormat)
+{
+	if ((valueFormat & 0x0004) == 0)
+		return 0;
+
+	return table.i16(offset + valueRecordSize(valueFormat & 0x0003));
+}
+
+//
+// Decodes one code point and advances pos, invalid sequences become U+FFFD
+//
+static uint32_t nextCodePoint(std::string_view utf8, size_t& pos)
+{
+	const uint8_t c = static_cast<uint8_t>(utf8[pos++]);
+
+	if (c < 0x80)
+		return c;
+
+	size_t length;
+	uint32_t codePoint;
+	uint32_t minimum;
+
+	if (c >= 0xC2 && c <= 0xDF)
+	{
+		length    = 1;
+		codePoint = c & 0x1F;
+		minimum   = 0x80;
+	}
+	else if (c >= 0xE0 && c <= 0xEF)
+	{
+		length    = 2;
+		codePoint = c & 0x0F;
+		minimum   = 0x800;
+	}
+	else if (c >= 0xF0 && c <= 0xF4)
+	{
+		length    = 3;
+		codePoint = c & 0x07;
+		minimum   = 0x10000;
+	}
+	else
+		return REPLACEMENT_CHARACTER;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		if (pos == utf8.size() || (static_cast<uint8_t>(utf8[pos]) & 0xC0) != 0x80)
+			return REPLACEMENT_CHARACTER;
+
+		codePoint = (codePoint << 6) | (static_cast<uint8_t>(utf8[pos++]) & 0x3F);
+	}
+
+	if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint < 0xE000))
+		return REPLACEMENT_CHARACTER;
+
+	return codePoint;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FontMetrics
+//
+
+bool FontMetrics::open(const std::string& path, const uint32_t pixelSize)
+{
+	close();
+
+	if (pixelSize == 0 || !m_file.open(path) || !readTables() || !readCharMap())
+	{
+		close();
+		return false;
+	}
+
+	m_pixelSize = pixelSize;
+	m_scale     = divFix(static_cast<int64_t>(pixelSize) * 64, m_unitsPerEm);
+
+	readPairPositioning();
+
+	// Resolve the metrics of every mapped BMP character up front, characters without a glyph use the missing glyph
+	m_missingGlyph = glyphMetrics(0);
+	m_pageIndex.assign(256, 0);
+
+	for (const CharGlyph& entry : m_charMap)
+	{
+		if (entry.codePoint > 0xFFFF)
+			break;
+
+		uint16_t& page = m_pageIndex[entry.codePoint >> 8];
+		if (page == 0)
+		{
+			m_pages.resize(m_pages.size() + 256, m_missingGlyph);
+			page = static_cast<uint16_t>(m_pages.size() / 256);
+		}
+
+		m_pages[(page - 1) * 256 + (entry.codePoint & 0xFF)] = glyphMetrics(entry.glyph);
+	}
+
+	return true;
+}
+
+void FontMetrics::close()
+{
+	m_file.close();
+
+	m_head = {};
+	m_hhea = {};
+	m_maxp = {};
+	m_hmtx = {};
+	m_loca = {};
+	m_glyf = {};
+	m_cmap = {};
+	m_kern = {};
+	m_gpos = {};
+
+	m_pixelSize     = 0;
+	m_unitsPerEm    = 0;
+	m_glyphCount    = 0;
+	m_hMetricsCount = 0;
+	m_longLoca      = false;
+	m_scale         = 0;
+
+	m_charMap.clear();
+	m_pairSubtables.clear();
+	m_pageIndex.clear();
+	m_pages.clear();
+	m_missingGlyph = {};
+}
+
+bool FontMetrics::readTables()
+{
+	const FontTable file = { m_file.data(), m_file.size() };
+
+	// Only plain TrueType outlines are supported, no collections and no CFF
+	const uint32_t version = file.u32(0);
+	if (version != 0x00010000 && version != makeTag("true"))
+		return false;
+
+	const uint16_t tableCount = file.u16(4);
+
+	for (uint16_t i = 0; i < tableCount; i++)
+	{
+		const size_t record   = 12 + static_cast<size_t>(i) * 16;
+		const uint32_t tag    = file.u32(record);
+		const uint32_t offset = file.u32(record + 8);
+		const uint32_t length = file.u32(record + 12);
+
+		if (static_cast<uint64_t>(offset) + length > m_file.size())
+			continue;
+
+		const FontTable table = { m_file.data() + offset, length };
+
+		if (tag == makeTag("head"))
+			m_head = table;
+		else if (tag == makeTag("hhea"))
+			m_hhea = table;
+		else if (tag == makeTag("maxp"))
+			m_maxp = table;
+		else if (tag == makeTag("hmtx"))
+			m_hmtx = table;
+		else if (tag == makeTag("loca"))
+			m_loca = table;
+		else if (tag == makeTag("glyf"))
+			m_glyf = table;
+		else if (tag == makeTag("cmap"))
+			m_cmap = table;
+		else if (tag == makeTag("kern"))
+			m_kern = table;
+		else if (tag == makeTag("GPOS"))
+			m_gpos = table;
+	}
+
+	if (m_head.size < 54 || m_hhea.size < 36 || m_maxp.size < 6 || m_hmtx.size == 0 || m_loca.size == 0 || m_glyf.size == 0 || m_cmap.size == 0)
+		return false;
+
+	m_unitsPerEm    = m_head.u16(18);
+	m_longLoca      = m_head.i16(50) != 0;
+	m_glyphCount    = m_maxp.u16(4);
+	m_hMetricsCount = m_hhea.u16(34);
+
+	return m_unitsPerEm >= 16 && m_glyphCount != 0 && m_hMetricsCount != 0;
+}
+
+//
+// Reads the Unicode mapping, preferring the full repertoire (format 12) over the BMP only one (format 4)
+//
+bool FontMetrics::readCharMap()
+{
+	size_t bestOffset = 0;
+	int bestScore     = 0;
+
+	const uint16_t subtableCount = m_cmap.u16(2);
+
+	for (uint16_t i = 0; i < subtableCount; i++)
+	{
+		const size_t record     = 4 + static_cast<size_t>(i) * 8;
+		const uint16_t platform = m_cmap.u16(record);
+		const uint16_t encoding = m_cmap.u16(record + 2);
+		const uint32_t offset   = m_cmap.u32(record + 4);
+		const uint16_t format   = m_cmap.u16(offset);
+		const bool unicode      = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+		const int score         = !unicode ? 0 : (format == 12 ? 2 : (format == 4 ? 1 : 0));
+
+		if (score > bestScore)
+		{
+			bestScore  = score;
+			bestOffset = offset;
+		}
+	}
+
+	if (bestScore == 0)
+		return false;
+
+	const auto addMapping = [this](const uint32_t codePoint, const uint32_t glyph) {
+		if (glyph != 0 && glyph < m_glyphCount)
+			m_charMap.push_back({ codePoint, static_cast<uint16_t>(glyph) });
+	};
+
+	if (bestScore == 2)
+	{
+		const uint32_t groupCount = m_cmap.u32(bestOffset + 12);
+
+		for (uint32_t i = 0; i < groupCount && bestOffset + 16 + static_cast<size_t>(i) * 12 < m_cmap.size; i++)
+		{
+			const size_t group        = bestOffset + 16 + static_cast<size_t>(i) * 12;
+			const uint32_t start      = m_cmap.u32(group);
+			const uint32_t end        = (std::min)(m_cmap.u32(group + 4), 0x10FFFFu);
+			const uint32_t startGlyph = m_cmap.u32(group + 8);
+
+			for (uint32_t codePoint = start; codePoint <= end; codePoint++)
+				addMapping(codePoint, startGlyph + (codePoint - start));
+		}
+	}
+	else
+	{
+		const uint16_t segmentCount = m_cmap.u16(bestOffset + 6) / 2;
+		const size_t endCodes       = bestOffset + 14;
+		const size_t startCodes     = endCodes + segmentCount * 2 + 2;
+		const size_t idDeltas       = startCodes + segmentCount * 2;
+		const size_t idRangeOffsets = idDeltas + segmentCount * 2;
+
+		for (uint16_t i = 0; i < segmentCount; i++)
+		{
+			const uint16_t end         = m_cmap.u16(endCodes + i * 2);
+			const uint16_t start       = m_cmap.u16(startCodes + i * 2);
+			const uint16_t delta       = m_cmap.u16(idDeltas + i * 2);
+			const size_t rangeOffsetAt = idRangeOffsets + i * 2;
+			const uint16_t rangeOffset = m_cmap.u16(rangeOffsetAt);
+
+			for (uint32_t codePoint = start; codePoint <= end && codePoint != 0xFFFF; codePoint++)
+			{
+				uint16_t glyph;
+
+				if (rangeOffset == 0)
+					glyph = static_cast<uint16_t>(codePoint + delta);
+				else
+				{
+					glyph = m_cmap.u16(rangeOffsetAt + rangeOffset + (codePoint - start) * 2);
+					if (glyph != 0)
+						glyph = static_cast<uint16_t>(glyph + delta);
+				}
+
+				addMapping(codePoint, glyph);
+			}
+		}
+	}
+
+	std::sort(m_charMap.begin(), m_charMap.end(), [](const CharGlyph& a, const CharGlyph& b) { return a.codePoint < b.codePoint; });
+
+	return !m_charMap.empty();
+}
+
+//
+// Collects the PairPos subtables of all lookups referenced by a kern feature, regardless of script and language
+//
+void FontMetrics::readPairPositioning()
+{
+	if (m_gpos.size < 10)
+		return;
+
+	const size_t featureList = m_gpos.u16(6);
+	const size_t lookupList  = m_gpos.u16(8);
+	const uint16_t lookups   = m_gpos.u16(lookupList);
+
+	std::vector<uint16_t> lookupIndices;
+	const uint16_t featureCount = m_gpos.u16(featureList);
+
+	for (uint16_t i = 0; i < featureCount; i++)
+	{
+		const size_t record = featureList + 2 + static_cast<size_t>(i) * 6;
+		if (m_gpos.u32(record) != makeTag("kern"))
+			continue;
+
+		const size_t feature       = featureList + m_gpos.u16(record + 4);
+		const uint16_t lookupCount = m_gpos.u16(feature + 2);
+
+		for (uint16_t j = 0; j < lookupCount; j++)
+		{
+			const uint16_t lookupIndex = m_gpos.u16(feature + 4 + static_cast<size_t>(j) * 2);
+			if (lookupIndex < lookups)
+				lookupIndices.push_back(lookupIndex);
+		}
+	}
+
+	std::sort(lookupIndices.begin(), lookupIndices.end());
+	lookupIndices.erase(std::unique(lookupIndices.begin(), lookupIndices.end()), lookupIndices.end());
+
+	for (const uint16_t lookupIndex : lookupIndices)
+	{
+		const size_t lookup          = lookupList + m_gpos.u16(lookupList + 2 + static_cast<size_t>(lookupIndex) * 2);
+		const uint16_t lookupType    = m_gpos.u16(lookup);
+		const uint16_t subtableCount = m_gpos.u16(lookup + 4);
+
+		for (uint16_t i = 0; i < subtableCount; i++)
+		{
+			size_t subtable = lookup + m_gpos.u16(lookup + 6 + static_cast<size_t>(i) * 2);
+
+			// Extension subtables point to the actual subtable with a 32 bit offset
+			if (lookupType == 9)
+			{
+				if (m_gpos.u16(subtable) != 1 || m_gpos.u16(subtable + 2) != 2)
+					continue;
+
+				subtable += m_gpos.u32(subtable + 4);
+			}
+			else if (lookupType != 2)
+				continue;
+
+			if (subtable < m_gpos.size)
+				m_pairSubtables.push_back(static_cast<uint32_t>(subtable));
+		}
+	}
+}
+
+uint16_t FontMetrics::glyphIndex(const uint32_t codePoint) const
+{
+	const auto it = std::lower_bound(m_charMap.begin(), m_charMap.end(), codePoint, [](const CharGlyph& entry, const uint32_t value) { return entry.codePoint < value; });
+	return (it != m_charMap.end() && it->codePoint == codePoint) ? it->glyph : 0;
+}
+
+//
+// Advance and horizontal bounds of a glyph as FreeType reports them for a hinted glyph.
+// Hinting does not move points horizontally with the default interpreter, so the unhinted bounding box is exact.
+//
+FontMetrics::GlyphMetrics FontMetrics::glyphMetrics(const uint16_t glyph) const
+{
+	GlyphMetrics metrics;
+	metrics.glyph = glyph;
+
+	if (glyph >= m_glyphCount)
+		return metrics;
+
+	const uint16_t advanceWidth = m_hmtx.u16(static_cast<size_t>((std::min)(glyph, static_cast<uint16_t>(m_hMetricsCount - 1))) * 4);
+	metrics.advance             = pixRound(mulFix(advanceWidth, m_scale));
+
+	const size_t start = m_longLoca ? m_loca.u32(static_cast<size_t>(glyph) * 4) : static_cast<size_t>(m_loca.u16(static_cast<size_t>(glyph) * 2)) * 2;
+	const size_t end   = m_longLoca ? m_loca.u32(static_cast<size_t>(glyph) * 4 + 4) : static_cast<size_t>(m_loca.u16(static_cast<size_t>(glyph) * 2 + 2)) * 2;
+
+	// Empty glyphs like the space have no outline and therefore no bounding box
+	if (end > start && start + 10 <= m_glyf.size)
+	{
+		metrics.xMin       = static_cast<int16_t>(pixFloor(mulFix(m_glyf.i16(start + 2), m_scale)) / 64);
+		metrics.xMax       = static_cast<int16_t>(pixCeil(mulFix(m_glyf.i16(start + 6), m_scale)) / 64);
+		metrics.hasOutline = true;
+	}
+
+	return metrics;
+}
+
+const FontMetrics::GlyphMetrics& FontMetrics::charMetrics(const uint32_t codePoint, GlyphMetrics& scratch) const
+{
+	if (codePoint <= 0xFFFF)
+	{
+		const uint16_t page = m_pageIndex[codePoint >> 8];
+		return page != 0 ? m_pages[(page - 1) * 256 + (codePoint & 0xFF)] : m_missingGlyph;
+	}
+
+	scratch = glyphMetrics(glyphIndex(codePoint));
+	return scratch;
+}
+
+//
+// Change of the advance of the left glyph in 26.6 when it is followed by the right one
+//
+int32_t FontMetrics::pairAdjustment(const uint16_t left, const uint16_t right) const
+{
+	if (left == 0 || right == 0)
+		return 0;
+
+	// PIL adds the kern table value in whole pixels to the 26.6 advance, mirrored to stay identical to fix.py
+	if (!m_pairAdjustments)
+		return toPixels(kernTableValue(left, right));
+
+	int32_t value = 0;
+	if (gposValue(left, right, value))
+		return pixRound(mulFix(value, m_scale));
+
+	return kernTableValue(left, right);
+}
+
+//
+// Kern table value scaled and grid fitted like FT_Get_Kerning with FT_KERNING_DEFAULT
+//
+int32_t FontMetrics::kernTableValue(const uint16_t left, const uint16_t right) const
+{
+	if (m_kern.size < 4 || m_kern.u16(0) != 0)
+		return 0;
+
+	const uint32_t key           = (static_cast<uint32_t>(left) << 16) | right;
+	const uint16_t subtableCount = m_kern.u16(2);
+	size_t subtable              = 4;
+	int32_t value                = 0;
+
+	for (uint16_t i = 0; i < subtableCount && subtable + 14 <= m_kern.size; i++)
+	{
+		const uint16_t length   = m_kern.u16(subtable + 2);
+		const uint16_t coverage = m_kern.u16(subtable + 4);
+
+		// Only horizontal format 0 subtables
+		if ((coverage >> 8) == 0 && (coverage & 0x0001) != 0 && (coverage & 0x0004) == 0)
+		{
+			uint32_t low  = 0;
+			uint32_t high = m_kern.u16(subtable + 6);
+
+			while (low < high)
+			{
+				const uint32_t mid     = (low + high) / 2;
+				const size_t pair      = subtable + 14 + static_cast<size_t>(mid) * 6;
+				const uint32_t pairKey = m_kern.u32(pair);
+
+				if (pairKey == key)
+				{
+					value = ((coverage & 0x0008) != 0) ? m_kern.i16(pair + 4) : value + m_kern.i16(pair + 4);
+					break;
+				}
+
+				if (pairKey < key)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+		}
+
+		if (length == 0)
+			break;
+
+		subtable += length;
+	}
+
+	if (value == 0)
+		return 0;
+
+	int32_t scaled = mulFix(value, m_scale);
+	if (m_pixelSize < KERNING_SCALE_PPEM)
+		scaled = mulDiv(scaled, m_pixelSize, KERNING_SCALE_PPEM);
+
+	return pixRound(scaled);
+}
+
+//
+// XAdvance of the first glyph from the first PairPos subtable that applies to the pair, in font units
+//
+bool FontMetrics::gposValue(const uint16_t left, const uint16_t right, int32_t& value) const
+{
+	for (const uint32_t subtable : m_pairSubtables)
+	{
+		const uint16_t format = m_gpos.u16(subtable);
+		const int32_t index   = coverageIndex(m_gpos, subtable + m_gpos.u16(subtable + 2), left);
+
+		if (index < 0)
+			continue;
+
+		const uint16_t valueFormat1 = m_gpos.u16(subtable + 4);
+		const uint16_t valueFormat2 = m_gpos.u16(subtable + 6);
+		const uint32_t recordSize   = valueRecordSize(valueFormat1) + valueRecordSize(valueFormat2);
+
+		if (format == 1)
+		{
+			if (index >= m_gpos.u16(subtable + 8))
+				continue;
+
+			const size_t pairSet = subtable + m_gpos.u16(subtable + 10 + static_cast<size_t>(index) * 2);
+			uint32_t low         = 0;
+			uint32_t high        = m_gpos.u16(pairSet);
+
+			while (low < high)
+			{
+				const uint32_t mid         = (low + high) / 2;
+				const size_t record        = pairSet + 2 + static_cast<size_t>(mid) * (2 + recordSize);
+				const uint16_t secondGlyph = m_gpos.u16(record);
+
+				if (secondGlyph == right)
+				{
+					value = valueRecordAdvance(m_gpos, record + 2, valueFormat1);
+					return true;
+				}
+
+				if (secondGlyph < right)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+		}
+		else if (format == 2)
+		{
+			const uint16_t class1      = glyphClass(m_gpos, subtable + m_gpos.u16(subtable + 8), left);
+			const uint16_t class2      = glyphClass(m_gpos, subtable + m_gpos.u16(subtable + 10), right);
+			const uint16_t class1Count = m_gpos.u16(subtable + 12);
+			const uint16_t class2Count = m_gpos.u16(subtable + 14);
+
+			if (class1 >= class1Count || class2 >= class2Count)
+				continue;
+
+			const size_t record = subtable + 16 + (static_cast<size_t>(class1) * class2Count + class2) * recordSize;
+			value               = valueRecordAdvance(m_gpos, record, valueFormat1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//
+// Follows PIL's bounding box calculation: every glyph is placed at the rounded pen position,
+// the width spans from the leftmost ink to the rightmost ink or pen position
+//
+uint32_t FontMetrics::lineWidth(std::string_view utf8) const
+{
+	if (!isOpen())
+		return 0;
+
+	int64_t position = 0;
+	int32_t xMin     = 0;
+	int32_t xMax     = 0;
+
+	const auto place = [&](const GlyphMetrics& metrics, const int32_t advance) {
+		const int32_t x = toPixels(position);
+
+		position += advance;
+		xMax = (std::max)(xMax, toPixels(position));
+
+		if (metrics.hasOutline)
+		{
+			xMin = (std::min)(xMin, x + metrics.xMin);
+			xMax = (std::max)(xMax, x + metrics.xMax);
+		}
+	};
+
+	// The advance of a glyph depends on the following one, so placing lags one character behind
+	GlyphMetrics scratch[2];
+	const GlyphMetrics* pPrevious = nullptr;
+	size_t pos                    = 0;
+
+	for (int i = 0; pos < utf8.size(); i ^= 1)
+	{
+		const GlyphMetrics& current = charMetrics(nextCodePoint(utf8, pos), scratch[i]);
+
+		if (pPrevious != nullptr)
+			place(*pPrevious, pPrevious->advance + pairAdjustment(pPrevious->glyph, current.glyph));
+
+		pPrevious = &current;
+	}
+
+	if (pPrevious != nullptr)
+		place(*pPrevious, pPrevious->advance);
+
+	return static_cast<uint32_t>(xMax - xMin);
+}
+
+void FontMetrics::lineWidths(std::string_view utf8, std::vector<uint32_t>& outWidths) const
+{
+	outWidths.clear();
+
+	size_t lineStart = 0;
+
+	while (true)
+	{
+		const size_t lineEnd = utf8.find('\n', lineStart);
+		outWidths.push_back(lineWidth(utf8.substr(lineStart, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - lineStart)));
+
+		if (lineEnd == std::string_view::npos)
+			break;
+
+		lineStart = lineEnd + 1;
+	}
+}
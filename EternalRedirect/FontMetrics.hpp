@@ -0,0 +1,157 @@
+/*
+ *  File: FontMetrics.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+//
+// Big endian view of a single table of a font file.
+// Reads outside of the table return 0, so a damaged font can not make the reader crash.
+//
+struct FontTable
+{
+	const uint8_t* pData = nullptr;
+	size_t size          = 0;
+
+	uint16_t u16(const size_t offset) const
+	{
+		return offset + 2 <= size ? static_cast<uint16_t>((pData[offset] << 8) | pData[offset + 1]) : 0;
+	}
+
+	int16_t i16(const size_t offset) const
+	{
+		return static_cast<int16_t>(u16(offset));
+	}
+
+	uint32_t u32(const size_t offset) const
+	{
+		return (static_cast<uint32_t>(u16(offset)) << 16) | u16(offset + 2);
+	}
+};
+
+//
+// Minimal TrueType reader that measures text at a fixed pixel size without rasterizing anything.
+// By default widths match what scripts/fix.py gets from PIL's basic layout: the pixel bounding box of the
+// glyphs and the pen advance, both rounded the way FreeType does for hinted glyphs.
+// The metrics of all BMP characters are resolved in open(), afterwards the object is immutable and can be shared between threads.
+//
+class FontMetrics
+{
+public:
+	FontMetrics() = default;
+
+	FontMetrics(const FontMetrics&)            = delete;
+	FontMetrics& operator=(const FontMetrics&) = delete;
+
+	bool open(const std::string& path, const uint32_t pixelSize);
+	void close();
+
+	bool isOpen() const
+	{
+		return m_file.isOpen();
+	}
+
+	// Apply pair adjustments from the kern table and GPOS pair positioning like a shaping engine would.
+	// Off by default, PIL's basic layout does not use GPOS and only adds the kern table values in 1/64 pixels.
+	void setPairAdjustments(const bool enabled)
+	{
+		m_pairAdjustments = enabled;
+	}
+
+	// Width of a single line of UTF-8 text in pixels
+	uint32_t lineWidth(std::string_view utf8) const;
+
+	// Width of every line of the text, split at '\n' like fix.py does
+	void lineWidths(std::string_view utf8, std::vector<uint32_t>& outWidths) const;
+
+private:
+	struct GlyphMetrics
+	{
+		uint16_t glyph  = 0;
+		int32_t advance = 0; // 26.6 fixed point
+
+		// Grid fitted pixel bounds relative to the pen position, only valid if hasOutline is set
+		int16_t xMin    = 0;
+		int16_t xMax    = 0;
+		bool hasOutline = false;
+	};
+
+	struct CharGlyph
+	{
+		uint32_t codePoint;
+		uint16_t glyph;
+	};
+
+	bool readTables();
+	bool readCharMap();
+	void readPairPositioning();
+
+	uint16_t glyphIndex(const uint32_t codePoint) const;
+	GlyphMetrics glyphMetrics(const uint16_t glyph) const;
+	const GlyphMetrics& charMetrics(const uint32_t codePoint, GlyphMetrics& scratch) const;
+
+	int32_t pairAdjustment(const uint16_t left, const uint16_t right) const;
+	int32_t kernTableValue(const uint16_t left, const uint16_t right) const;
+	bool gposValue(const uint16_t left, const uint16_t right, int32_t& value) const;
+
+private:
+	MappedFile m_file;
+
+	FontTable m_head;
+	FontTable m_hhea;
+	FontTable m_maxp;
+	FontTable m_hmtx;
+	FontTable m_loca;
+	FontTable m_glyf;
+	FontTable m_cmap;
+	FontTable m_kern;
+	FontTable m_gpos;
+
+	uint32_t m_pixelSize     = 0;
+	uint16_t m_unitsPerEm    = 0;
+	uint16_t m_glyphCount    = 0;
+	uint16_t m_hMetricsCount = 0;
+	bool m_longLoca          = false;
+	int32_t m_scale          = 0; // 16.16 fixed point, font units to 26.6
+	bool m_pairAdjustments   = false;
+
+	// Sorted by code point
+	std::vector<CharGlyph> m_charMap;
+
+	// Offsets of the GPOS PairPos subtables used by the kern feature
+	std::vector<uint32_t> m_pairSubtables;
+
+	// Metrics of all BMP characters in pages of 256, m_pageIndex holds the page number plus one or 0 for unmapped pages
+	std::vector<uint16_t> m_pageIndex;
+	std::vector<GlyphMetrics> m_pages;
+	GlyphMetrics m_missingGlyph;
+};
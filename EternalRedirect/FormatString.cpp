@@ -0,0 +1,245 @@
+/*
+ *  File: FormatString.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#include "FormatString.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Far more than any format string of the game uses, keeps bogus positions from growing the argument list
+static constexpr uint32_t MAX_ARGS = 64;
+
+static bool isDigit(const char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static uint32_t readNumber(std::string_view format, size_t& pos)
+{
+	uint32_t value = 0;
+
+	while (pos < format.size() && isDigit(format[pos]))
+	{
+		value = (std::min)(value * 10 + static_cast<uint32_t>(format[pos] - '0'), MAX_ARGS + 1);
+		pos++;
+	}
+
+	return value;
+}
+
+//
+// Reads "n$" at pos, returns the position or 0 without moving pos if there is none
+//
+static uint32_t readPosition(std::string_view format, size_t& pos)
+{
+	size_t end              = pos;
+	const uint32_t position = readNumber(format, end);
+
+	if (end == pos || end >= format.size() || format[end] != '$')
+		return 0;
+
+	pos = end + 1;
+	return position;
+}
+
+//
+// A position may be read more than once, but always with the same type
+//
+static bool setArg(std::vector<FormatArg>& args, const uint32_t position, const FormatArg type)
+{
+	if (position == 0 || position > MAX_ARGS)
+		return false;
+
+	if (args.size() < position)
+		args.resize(position, FormatArg::None);
+
+	FormatArg& arg = args[position - 1];
+	if (arg != FormatArg::None && arg != type)
+		return false;
+
+	arg = type;
+	return true;
+}
+
+//
+// Type of a conversion character with its length modifier, FormatArg::None if the combination is not supported
+//
+static FormatArg conversionType(const char conversion, std::string_view length)
+{
+	const bool isLong64 = length == "ll" || length == "I64" || length == "I" || length == "j" || length == "z" || length == "t";
+	const bool isShort  = length.empty() || length == "hh" || length == "h" || length == "l" || length == "I32";
+	const bool isWide   = length == "l" || length == "w";
+
+	switch (conversion)
+	{
+	case 'd':
+	case 'i':
+	case 'o':
+	case 'u':
+	case 'x':
+	case 'X':
+		return isLong64 ? FormatArg::Int64 : (isShort ? FormatArg::Int : FormatArg::None);
+	case 'c':
+	case 'C':
+		return (length.empty() || length == "h" || isWide) ? FormatArg::Int : FormatArg::None;
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		return (length.empty() || length == "l" || length == "L") ? FormatArg::Double : FormatArg::None;
+	case 'p':
+		return length.empty() ? FormatArg::Pointer : FormatArg::None;
+	case 's':
+		return length.empty() || length == "h" ? FormatArg::String : (isWide ? FormatArg::WideString : FormatArg::None);
+	case 'S':
+		return length == "h" ? FormatArg::String : (length.empty() || isWide ? FormatArg::WideString : FormatArg::None);
+	default:
+		// Includes %n, which would let a translation write to the game's memory
+		return FormatArg::None;
+	}
+}
+
+static std::string_view readLength(std::string_view format, size_t& pos)
+{
+	static const std::string_view LENGTHS[] = { "hh", "h", "ll", "l", "L", "I64", "I32", "I", "j", "z", "t", "w" };
+
+	for (const std::string_view length : LENGTHS)
+	{
+		if (format.compare(pos, length.size(), length) == 0)
+		{
+			pos += length.size();
+			return length;
+		}
+	}
+
+	return {};
+}
+
+bool parseFormatArgs(std::string_view format, std::vector<FormatArg>& outArgs)
+{
+	outArgs.clear();
+
+	enum class Mode
+	{
+		Unknown,
+		Sequential,
+		Positional,
+	};
+
+	Mode mode             = Mode::Unknown;
+	uint32_t nextPosition = 1;
+
+	// Width and precision may also be read from an int argument
+	const auto readStar = [&](size_t& pos) {
+		if (mode == Mode::Positional)
+			return setArg(outArgs, readPosition(format, pos), FormatArg::Int);
+
+		return setArg(outArgs, nextPosition++, FormatArg::Int);
+	};
+
+	size_t pos = 0;
+	while ((pos = format.find('%', pos)) != std::string_view::npos)
+	{
+		pos++;
+
+		if (pos < format.size() && format[pos] == '%')
+		{
+			pos++;
+			continue;
+		}
+
+		const uint32_t position   = readPosition(format, pos);
+		const Mode conversionMode = position != 0 ? Mode::Positional : Mode::Sequential;
+
+		if (mode != Mode::Unknown && mode != conversionMode)
+			return false;
+
+		mode = conversionMode;
+
+		while (pos < format.size() && strchr("-+ #0", format[pos]) != nullptr)
+			pos++;
+
+		if (pos < format.size() && format[pos] == '*')
+		{
+			pos++;
+			if (!readStar(pos))
+				return false;
+		}
+		else
+			readNumber(format, pos);
+
+		if (pos < format.size() && format[pos] == '.')
+		{
+			pos++;
+
+			if (pos < format.size() && format[pos] == '*')
+			{
+				pos++;
+				if (!readStar(pos))
+					return false;
+			}
+			else
+				readNumber(format, pos);
+		}
+
+		const std::string_view length = readLength(format, pos);
+		if (pos >= format.size())
+			return false;
+
+		const FormatArg type = conversionType(format[pos], length);
+		pos++;
+
+		if (type == FormatArg::None || !setArg(outArgs, mode == Mode::Positional ? position : nextPosition++, type))
+			return false;
+	}
+
+	// _vsprintf_p can not skip over an argument it does not know the type of
+	for (const FormatArg arg : outArgs)
+	{
+		if (arg == FormatArg::None)
+			return false;
+	}
+
+	return true;
+}
+
+bool isCompatibleFormat(std::string_view format, std::string_view translation)
+{
+	if (format.find('%') == std::string_view::npos)
+		return true;
+
+	// The hook still formats a translation of a key that does not parse, with arguments of unknown type.
+	// Such a translation may only contain literal percent signs.
+	std::vector<FormatArg> formatArgs;
+	if (!parseFormatArgs(format, formatArgs))
+		formatArgs.clear();
+
+	std::vector<FormatArg> translationArgs;
+	return parseFormatArgs(translation, translationArgs) && translationArgs == formatArgs;
+}
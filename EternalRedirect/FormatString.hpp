@@ -0,0 +1,60 @@
+/*
+ *  File: FormatString.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+//
+// Type of an argument read by a printf conversion.
+// Integers are told apart by size because that decides how many bytes va_arg takes from the game's arguments.
+//
+enum class FormatArg : uint8_t
+{
+	None,
+	Int,
+	Int64,
+	Double,
+	Pointer,
+	String,
+	WideString,
+};
+
+//
+// Collects the arguments a printf format string reads, indexed by argument position.
+// Follows the MSVC CRT including positional conversions like %2$s as _vsprintf_p understands them.
+// Returns false for malformed conversions, %n, mixed positional and sequential conversions and unused positions.
+//
+bool parseFormatArgs(std::string_view format, std::vector<FormatArg>& outArgs);
+
+//
+// A translated template is formatted with the arguments of the original format string.
+// It is only safe to do so if it reads exactly the same arguments, the order of the conversions may differ.
+// Keys without a percent sign are drawn as they are and accept any translation. Keys that contain one but
+// are not valid format strings only accept translations without conversions, "%%" is fine.
+//
+bool isCompatibleFormat(std::string_view format, std::string_view translation);
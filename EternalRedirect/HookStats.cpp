@@ -0,0 +1,139 @@
+/*
+ *  File: HookStats.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "HookStats.hpp"
+
+#if INCLUDE_HOOK_STATS
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <vector>
+
+namespace stats
+{
+static const char* HOOK_NAMES[] = {
+	"DrawFormatVStringToHandle",
+	"CopyFunc",
+	"GetDrawFormatStringWidth",
+	"SetWindowTitle",
+	"CopyEnemyNameFunc",
+};
+
+static_assert(sizeof(HOOK_NAMES) / sizeof(HOOK_NAMES[0]) == static_cast<uint32_t>(Hook::COUNT), "Every hook needs a name");
+
+std::mutex g_threadsMutex;
+std::vector<std::unique_ptr<ThreadStats>> g_threads;
+
+ThreadStats* registerThread()
+{
+	std::lock_guard<std::mutex> lock(g_threadsMutex);
+
+	g_threads.push_back(std::make_unique<ThreadStats>());
+	return g_threads.back().get();
+}
+
+static void appendLine(std::string& out, const char* pFormat, ...)
+{
+	char line[256];
+
+	va_list args;
+	va_start(args, pFormat);
+	vsnprintf(line, sizeof(line), pFormat, args);
+	va_end(args);
+
+	out += line;
+}
+
+std::string report()
+{
+	struct Totals
+	{
+		uint64_t calls  = 0;
+		uint64_t hits   = 0;
+		uint64_t misses = 0;
+		uint64_t bytes  = 0;
+		uint64_t ticks  = 0;
+		uint64_t histogram[HISTOGRAM_BUCKETS] = {};
+	};
+
+	Totals totals[static_cast<uint32_t>(Hook::COUNT)];
+	size_t threadCount = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(g_threadsMutex);
+
+		threadCount = g_threads.size();
+
+		for (const std::unique_ptr<ThreadStats>& pThread : g_threads)
+		{
+			for (uint32_t i = 0; i < static_cast<uint32_t>(Hook::COUNT); i++)
+			{
+				const HookCounters& counters = pThread->hooks[i];
+				Totals& total                = totals[i];
+
+				total.calls += counters.calls.load(std::memory_order_relaxed);
+				total.hits += counters.hits.load(std::memory_order_relaxed);
+				total.misses += counters.misses.load(std::memory_order_relaxed);
+				total.bytes += counters.bytes.load(std::memory_order_relaxed);
+				total.ticks += counters.ticks.load(std::memory_order_relaxed);
+
+				for (uint32_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+					total.histogram[b] += counters.histogram[b].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	const double nsPerTick = 1e9 / static_cast<double>(ticksPerSecond());
+	std::string out;
+
+	appendLine(out, "Hook statistics (%u threads)\n", static_cast<unsigned>(threadCount));
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(Hook::COUNT); i++)
+	{
+		const Totals& total = totals[i];
+		if (total.calls == 0)
+			continue;
+
+		appendLine(out, "%s: calls %llu, hits %llu, misses %llu, bytes %llu, mean %.1f ns\n", HOOK_NAMES[i],
+				   static_cast<unsigned long long>(total.calls), static_cast<unsigned long long>(total.hits),
+				   static_cast<unsigned long long>(total.misses), static_cast<unsigned long long>(total.bytes),
+				   static_cast<double>(total.ticks) * nsPerTick / static_cast<double>(total.calls));
+
+		for (uint32_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+		{
+			if (total.histogram[b] == 0)
+				continue;
+
+			const double upperNs = static_cast<double>(2ull << b) * nsPerTick;
+			appendLine(out, "  < %12.0f ns: %llu\n", upperNs, static_cast<unsigned long long>(total.histogram[b]));
+		}
+	}
+
+	return out;
+}
+} // namespace stats
+#endif
@@ -0,0 +1,188 @@
+/*
+ *  File: HookStats.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#ifndef INCLUDE_HOOK_STATS
+#define INCLUDE_HOOK_STATS 0
+#endif
+
+//
+// Call counters and latency histograms for the detoured functions.
+// Every thread records into its own block of counters, so recording never takes a lock.
+// The blocks are only summed up when a report is requested.
+//
+namespace stats
+{
+enum class Hook : uint32_t
+{
+	DrawFormatVStringToHandle = 0,
+	CopyFunc,
+	GetDrawFormatStringWidth,
+	SetWindowTitle,
+	CopyEnemyNameFunc,
+	COUNT
+};
+
+// Bucket i counts calls that took [2^i, 2^(i+1)) timer ticks
+static constexpr uint32_t HISTOGRAM_BUCKETS = 32;
+
+#if INCLUDE_HOOK_STATS
+struct HookCounters
+{
+	std::atomic<uint64_t> calls  = 0;
+	std::atomic<uint64_t> hits   = 0;
+	std::atomic<uint64_t> misses = 0;
+	std::atomic<uint64_t> bytes  = 0;
+	std::atomic<uint64_t> ticks  = 0;
+	std::atomic<uint64_t> histogram[HISTOGRAM_BUCKETS] = {};
+};
+
+struct ThreadStats
+{
+	HookCounters hooks[static_cast<uint32_t>(Hook::COUNT)];
+};
+
+// Registers the block of the calling thread, blocks stay alive until the process exits
+ThreadStats* registerThread();
+
+// Sums up the counters of all threads into a human readable report
+std::string report();
+
+inline ThreadStats& threadStats()
+{
+	thread_local ThreadStats* t_pStats = nullptr;
+
+	if (t_pStats == nullptr)
+		t_pStats = registerThread();
+
+	return *t_pStats;
+}
+
+inline uint64_t now()
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return static_cast<uint64_t>(counter.QuadPart);
+#else
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline uint64_t ticksPerSecond()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return static_cast<uint64_t>(frequency.QuadPart);
+#else
+	return 1000000000ull;
+#endif
+}
+
+inline uint32_t histogramBucket(uint64_t ticks)
+{
+	uint32_t bucket = 0;
+
+	while (ticks > 1 && bucket < HISTOGRAM_BUCKETS - 1)
+	{
+		ticks >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+//
+// Records a single call of a hook, the latency is taken when the scope is left
+//
+class HookScope
+{
+public:
+	explicit HookScope(const Hook hook) :
+		m_counters(threadStats().hooks[static_cast<uint32_t>(hook)]), m_start(now()) {}
+
+	~HookScope()
+	{
+		const uint64_t ticks = now() - m_start;
+
+		add(m_counters.calls, 1);
+		add(m_counters.ticks, ticks);
+		add(m_counters.histogram[histogramBucket(ticks)], 1);
+	}
+
+	HookScope(const HookScope&)            = delete;
+	HookScope& operator=(const HookScope&) = delete;
+
+	void hit(const size_t bytes = 0)
+	{
+		add(m_counters.hits, 1);
+		add(m_counters.bytes, bytes);
+	}
+
+	void miss()
+	{
+		add(m_counters.misses, 1);
+	}
+
+private:
+	// Only the owning thread writes a counter, so a plain load and store is enough
+	static void add(std::atomic<uint64_t>& counter, const uint64_t value)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+private:
+	HookCounters& m_counters;
+	uint64_t m_start;
+};
+#else
+class HookScope
+{
+public:
+	explicit HookScope(const Hook) {}
+
+	void hit(const size_t = 0) {}
+	void miss() {}
+};
+
+inline std::string report()
+{
+	return {};
+}
+#endif
+} // namespace stats
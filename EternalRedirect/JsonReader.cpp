@@ -0,0 +1,298 @@
+/*
+ *  File: JsonReader.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "JsonReader.hpp"
+
+std::string_view JsonReader::readString()
+{
+	expect('"');
+
+	// Strings without escapes are returned straight from the mapping
+	const size_t start = m_pos;
+	while (m_pos < m_size && m_pData[m_pos] != '"' && m_pData[m_pos] != '\\')
+	{
+		if (static_cast<uint8_t>(m_pData[m_pos]) < 0x20)
+			fail("control character in string");
+
+		m_pos++;
+	}
+
+	if (m_pos == m_size)
+		fail("unterminated string");
+
+	if (m_pData[m_pos] == '"')
+		return std::string_view(m_pData + start, m_pos++ - start);
+
+	m_unescaped.assign(m_pData + start, m_pos - start);
+
+	while (true)
+	{
+		if (m_pos == m_size)
+			fail("unterminated string");
+
+		const char c = m_pData[m_pos++];
+
+		if (c == '"')
+			return m_unescaped;
+
+		if (static_cast<uint8_t>(c) < 0x20)
+		{
+			m_pos--;
+			fail("control character in string");
+		}
+
+		if (c != '\\')
+		{
+			m_unescaped.push_back(c);
+			continue;
+		}
+
+		if (m_pos == m_size)
+			fail("unterminated string");
+
+		switch (m_pData[m_pos++])
+		{
+			case '"':
+				m_unescaped.push_back('"');
+				break;
+			case '\\':
+				m_unescaped.push_back('\\');
+				break;
+			case '/':
+				m_unescaped.push_back('/');
+				break;
+			case 'b':
+				m_unescaped.push_back('\b');
+				break;
+			case 'f':
+				m_unescaped.push_back('\f');
+				break;
+			case 'n':
+				m_unescaped.push_back('\n');
+				break;
+			case 'r':
+				m_unescaped.push_back('\r');
+				break;
+			case 't':
+				m_unescaped.push_back('\t');
+				break;
+			case 'u':
+			{
+				uint32_t codePoint = readHex4();
+
+				if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+				{
+					if (m_pos + 2 > m_size || m_pData[m_pos] != '\\' || m_pData[m_pos + 1] != 'u')
+						fail("missing low surrogate");
+
+					m_pos += 2;
+					const uint32_t low = readHex4();
+					if (low < 0xDC00 || low > 0xDFFF)
+						fail("invalid low surrogate");
+
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+				else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+					fail("unexpected low surrogate");
+
+				if (codePoint < 0x80)
+					m_unescaped.push_back(static_cast<char>(codePoint));
+				else if (codePoint < 0x800)
+				{
+					m_unescaped.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+					m_unescaped.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+				}
+				else if (codePoint < 0x10000)
+				{
+					m_unescaped.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+					m_unescaped.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+					m_unescaped.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+				}
+				else
+				{
+					m_unescaped.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+					m_unescaped.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+					m_unescaped.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+					m_unescaped.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+				}
+				break;
+			}
+			default:
+				m_pos--;
+				fail("invalid escape sequence");
+		}
+	}
+}
+
+uint32_t JsonReader::readHex4()
+{
+	if (m_pos + 4 > m_size)
+		fail("truncated unicode escape");
+
+	uint32_t value = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		const char c = m_pData[m_pos];
+		value <<= 4;
+
+		if (c >= '0' && c <= '9')
+			value |= c - '0';
+		else if (c >= 'a' && c <= 'f')
+			value |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			value |= c - 'A' + 10;
+		else
+			fail("invalid unicode escape");
+
+		m_pos++;
+	}
+
+	return value;
+}
+
+bool JsonReader::readUInt32(uint32_t& value)
+{
+	skipWhitespace();
+
+	bool isUInt32   = true;
+	uint64_t result = 0;
+
+	if (m_pos < m_size && m_pData[m_pos] == '-')
+	{
+		isUInt32 = false;
+		m_pos++;
+	}
+
+	if (!isDigit())
+		fail("expected a number");
+
+	// Leading zeros are not allowed
+	if (m_pData[m_pos] == '0')
+		m_pos++;
+	else
+	{
+		while (isDigit())
+		{
+			result = result * 10 + (m_pData[m_pos++] - '0');
+			if (result > UINT32_MAX)
+			{
+				isUInt32 = false;
+				result   = 0;
+			}
+		}
+	}
+
+	if (m_pos < m_size && m_pData[m_pos] == '.')
+	{
+		isUInt32 = false;
+		m_pos++;
+
+		if (!isDigit())
+			fail("expected a digit after the decimal point");
+
+		while (isDigit())
+			m_pos++;
+	}
+
+	if (m_pos < m_size && (m_pData[m_pos] == 'e' || m_pData[m_pos] == 'E'))
+	{
+		isUInt32 = false;
+		m_pos++;
+
+		if (m_pos < m_size && (m_pData[m_pos] == '+' || m_pData[m_pos] == '-'))
+			m_pos++;
+
+		if (!isDigit())
+			fail("expected a digit in the exponent");
+
+		while (isDigit())
+			m_pos++;
+	}
+
+	value = static_cast<uint32_t>(result);
+	return isUInt32;
+}
+
+void JsonReader::skipLiteral(const char* pLiteral)
+{
+	const size_t length = strlen(pLiteral);
+
+	if (m_pos + length > m_size || memcmp(m_pData + m_pos, pLiteral, length) != 0)
+		fail("invalid literal");
+
+	m_pos += length;
+}
+
+void JsonReader::skipValue()
+{
+	uint32_t number;
+
+	switch (peek())
+	{
+		case '{':
+			m_pos++;
+			if (consume('}'))
+				return;
+
+			do
+			{
+				readString();
+				expect(':');
+				skipValue();
+			} while (consume(','));
+
+			expect('}');
+			return;
+		case '[':
+			m_pos++;
+			if (consume(']'))
+				return;
+
+			do
+			{
+				skipValue();
+			} while (consume(','));
+
+			expect(']');
+			return;
+		case '"':
+			readString();
+			return;
+		case 't':
+			skipLiteral("true");
+			return;
+		case 'f':
+			skipLiteral("false");
+			return;
+		case 'n':
+			skipLiteral("null");
+			return;
+		default:
+			readUInt32(number);
+			return;
+	}
+}
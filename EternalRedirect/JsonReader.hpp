@@ -0,0 +1,127 @@
+/*
+ *  File: JsonReader.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+//
+// Minimal pull parser working directly on a buffer, usually a mapped file.
+// Only strings and unsigned integers are decoded, everything else is validated and skipped.
+//
+class JsonReader
+{
+public:
+	JsonReader(const char* pData, const size_t size) :
+		m_pData(pData),
+		m_size(size)
+	{
+		// Skip a UTF-8 byte order mark
+		if (m_size >= 3 && memcmp(m_pData, "\xEF\xBB\xBF", 3) == 0)
+			m_pos = 3;
+	}
+
+	// Offset of the next token
+	size_t offset()
+	{
+		skipWhitespace();
+		return m_pos;
+	}
+
+	// Offset right after the last consumed token, whitespace is not skipped
+	size_t position() const
+	{
+		return m_pos;
+	}
+
+	bool atEnd()
+	{
+		skipWhitespace();
+		return m_pos == m_size;
+	}
+
+	// Next non whitespace character without consuming it, 0 at the end of the data
+	char peek()
+	{
+		skipWhitespace();
+		return m_pos < m_size ? m_pData[m_pos] : 0;
+	}
+
+	bool consume(const char c)
+	{
+		if (peek() != c)
+			return false;
+
+		m_pos++;
+		return true;
+	}
+
+	void expect(const char c)
+	{
+		if (!consume(c))
+			fail(std::string("expected '") + c + "'");
+	}
+
+	// The returned view points into the file or into an internal buffer and is valid until the next call
+	std::string_view readString();
+
+	// Returns false if the number is not an integer that fits into an uint32_t
+	bool readUInt32(uint32_t& value);
+
+	void skipValue();
+
+	[[noreturn]] void fail(const std::string& what) const
+	{
+		throw std::runtime_error("Syntax error at byte " + std::to_string(m_pos) + ": " + what);
+	}
+
+private:
+	void skipWhitespace()
+	{
+		while (m_pos < m_size && (m_pData[m_pos] == ' ' || m_pData[m_pos] == '\n' || m_pData[m_pos] == '\r' || m_pData[m_pos] == '\t'))
+			m_pos++;
+	}
+
+	bool isDigit() const
+	{
+		return m_pos < m_size && m_pData[m_pos] >= '0' && m_pData[m_pos] <= '9';
+	}
+
+	void skipLiteral(const char* pLiteral);
+	uint32_t readHex4();
+
+private:
+	const char* m_pData = nullptr;
+	size_t m_size       = 0;
+	size_t m_pos        = 0;
+
+	std::string m_unescaped;
+};
@@ -0,0 +1,168 @@
+/*
+ *  File: JsonWriter.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "JsonWriter.hpp"
+
+static const size_t INDENT_WIDTH = 4;
+static const size_t FLUSH_SIZE   = 64 * 1024;
+
+void JsonWriter::beginObject()
+{
+	beginValue();
+	m_buffer.push_back('{');
+	m_hasItems.push_back(false);
+}
+
+void JsonWriter::endObject()
+{
+	endContainer('}');
+}
+
+void JsonWriter::beginArray()
+{
+	beginValue();
+	m_buffer.push_back('[');
+	m_hasItems.push_back(false);
+}
+
+void JsonWriter::endArray()
+{
+	endContainer(']');
+}
+
+void JsonWriter::key(std::string_view name)
+{
+	beginValue();
+	appendEscaped(name);
+	m_buffer += ": ";
+	m_afterKey = true;
+}
+
+void JsonWriter::string(std::string_view text)
+{
+	beginValue();
+	appendEscaped(text);
+}
+
+void JsonWriter::number(const uint32_t value)
+{
+	beginValue();
+	m_buffer += std::to_string(value);
+}
+
+void JsonWriter::raw(std::string_view json)
+{
+	beginValue();
+	m_buffer.append(json);
+}
+
+void JsonWriter::flush()
+{
+	m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+	m_buffer.clear();
+}
+
+// Puts every item of a container on its own line, values of keys follow the key directly
+void JsonWriter::beginValue()
+{
+	if (m_buffer.size() >= FLUSH_SIZE)
+		flush();
+
+	if (m_afterKey)
+	{
+		m_afterKey = false;
+		return;
+	}
+
+	if (m_hasItems.empty())
+		return;
+
+	m_buffer += m_hasItems.back() ? ",\n" : "\n";
+	m_buffer.append(m_hasItems.size() * INDENT_WIDTH, ' ');
+	m_hasItems.back() = true;
+}
+
+// Empty containers are closed on the same line
+void JsonWriter::endContainer(const char close)
+{
+	const bool hasItems = m_hasItems.back();
+	m_hasItems.pop_back();
+
+	if (hasItems)
+	{
+		m_buffer.push_back('\n');
+		m_buffer.append(m_hasItems.size() * INDENT_WIDTH, ' ');
+	}
+
+	m_buffer.push_back(close);
+}
+
+// Only quotes, backslashes and control characters are escaped
+void JsonWriter::appendEscaped(std::string_view text)
+{
+	static const char HEX_DIGITS[] = "0123456789abcdef";
+
+	m_buffer.push_back('"');
+
+	for (const char c : text)
+	{
+		switch (c)
+		{
+			case '"':
+				m_buffer += "\\\"";
+				break;
+			case '\\':
+				m_buffer += "\\\\";
+				break;
+			case '\b':
+				m_buffer += "\\b";
+				break;
+			case '\f':
+				m_buffer += "\\f";
+				break;
+			case '\n':
+				m_buffer += "\\n";
+				break;
+			case '\r':
+				m_buffer += "\\r";
+				break;
+			case '\t':
+				m_buffer += "\\t";
+				break;
+			default:
+				if (static_cast<uint8_t>(c) < 0x20)
+				{
+					m_buffer += "\\u00";
+					m_buffer.push_back(HEX_DIGITS[c >> 4]);
+					m_buffer.push_back(HEX_DIGITS[c & 0xF]);
+				}
+				else
+					m_buffer.push_back(c);
+		}
+	}
+
+	m_buffer.push_back('"');
+}
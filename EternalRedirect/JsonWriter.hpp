@@ -0,0 +1,84 @@
+/*
+ *  File: JsonWriter.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//
+// Streaming writer producing the same text as nlohmann::json::dump(4) and json.dump(indent=4, ensure_ascii=False) in Python.
+// Output is collected in a small buffer that is passed to the stream whenever it fills up.
+//
+class JsonWriter
+{
+public:
+	explicit JsonWriter(std::ostream& stream) :
+		m_stream(stream)
+	{
+	}
+
+	~JsonWriter()
+	{
+		flush();
+	}
+
+	JsonWriter(const JsonWriter&)            = delete;
+	JsonWriter& operator=(const JsonWriter&) = delete;
+
+	void beginObject();
+	void endObject();
+	void beginArray();
+	void endArray();
+
+	// Must be followed by the value of the key
+	void key(std::string_view name);
+
+	// The text must be valid UTF-8, it is copied as is apart from the escapes JSON requires
+	void string(std::string_view text);
+	void number(const uint32_t value);
+
+	// Writes an already serialized value as is
+	void raw(std::string_view json);
+
+	void flush();
+
+private:
+	void beginValue();
+	void endContainer(const char close);
+	void appendEscaped(std::string_view text);
+
+private:
+	std::ostream& m_stream;
+	std::string m_buffer;
+
+	// One entry per open container, true once it has an item
+	std::vector<bool> m_hasItems;
+	bool m_afterKey = false;
+};
@@ -0,0 +1,128 @@
+/*
+ *  File: SignatureCache.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "SignatureCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "TranslationTable.hpp"
+
+// Offsets in the PE headers, the fields used are at the same place for 32 and 64 bit images
+static const size_t DOS_LFANEW_OFFSET    = 0x3C;
+static const size_t NT_TIME_STAMP_OFFSET = 8;
+static const size_t NT_OPTIONAL_OFFSET   = 24;
+static const size_t OPT_SIZE_OF_IMAGE    = 56;
+static const size_t OPT_SIZE_OF_HEADERS  = 60;
+static const size_t OPT_CHECK_SUM        = 64;
+static const size_t OPT_MIN_SIZE         = 68;
+
+static uint32_t readUInt32(const uint8_t* pData)
+{
+	uint32_t value;
+	memcpy(&value, pData, sizeof(value));
+	return value;
+}
+
+bool readImageIdentity(const uint8_t* pHeader, const size_t headerSize, const uint64_t fileSize, ImageIdentity& identity)
+{
+	if (headerSize < DOS_LFANEW_OFFSET + 4 || pHeader[0] != 'M' || pHeader[1] != 'Z')
+		return false;
+
+	const size_t ntOffset = readUInt32(pHeader + DOS_LFANEW_OFFSET);
+
+	if (ntOffset > headerSize || headerSize - ntOffset < NT_OPTIONAL_OFFSET + OPT_MIN_SIZE || memcmp(pHeader + ntOffset, "PE\0\0", 4) != 0)
+		return false;
+
+	const uint8_t* pOptional = pHeader + ntOffset + NT_OPTIONAL_OFFSET;
+
+	// The loader writes the actual image base into the mapped headers, the file keeps the original ones
+	const size_t hashedSize = (std::min)(static_cast<size_t>(readUInt32(pOptional + OPT_SIZE_OF_HEADERS)), headerSize);
+
+	identity.timeDateStamp = readUInt32(pHeader + ntOffset + NT_TIME_STAMP_OFFSET);
+	identity.sizeOfImage   = readUInt32(pOptional + OPT_SIZE_OF_IMAGE);
+	identity.checkSum      = readUInt32(pOptional + OPT_CHECK_SUM);
+	identity.fileSize      = fileSize;
+	identity.headerHash    = hashBytes(reinterpret_cast<const char*>(pHeader), hashedSize);
+
+	return true;
+}
+
+bool loadSignatureCache(const std::string& path, const ImageIdentity& identity, std::vector<uint32_t>& outRvas)
+{
+	if (!identity.isValid())
+		return false;
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	sigcache::Header header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+
+	if (header.magic != sigcache::MAGIC || header.version != sigcache::VERSION || header.rvaCount > sigcache::MAX_RVA_COUNT)
+		return false;
+
+	const ImageIdentity cached = { header.timeDateStamp, header.sizeOfImage, header.checkSum, header.fileSize, header.headerHash };
+	if (!(cached == identity))
+		return false;
+
+	outRvas.resize(header.rvaCount);
+	if (!file.read(reinterpret_cast<char*>(outRvas.data()), static_cast<std::streamsize>(outRvas.size() * sizeof(uint32_t))))
+	{
+		outRvas.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool saveSignatureCache(const std::string& path, const ImageIdentity& identity, const std::vector<uint32_t>& rvas)
+{
+	if (!identity.isValid())
+		return false;
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	sigcache::Header header = {};
+	header.magic            = sigcache::MAGIC;
+	header.version          = sigcache::VERSION;
+	header.timeDateStamp    = identity.timeDateStamp;
+	header.sizeOfImage      = identity.sizeOfImage;
+	header.checkSum         = identity.checkSum;
+	header.rvaCount         = static_cast<uint32_t>(rvas.size());
+	header.fileSize         = identity.fileSize;
+	header.headerHash       = identity.headerHash;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(rvas.data()), static_cast<std::streamsize>(rvas.size() * sizeof(uint32_t)));
+
+	return static_cast<bool>(file);
+}
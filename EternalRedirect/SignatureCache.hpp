@@ -0,0 +1,89 @@
+/*
+ *  File: SignatureCache.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// Identifies a build of the game, resolved signatures are only reused for the exact same build.
+// Everything is taken from the file on disk, so relocating the image does not change the identity.
+//
+struct ImageIdentity
+{
+	uint32_t timeDateStamp = 0;
+	uint32_t sizeOfImage   = 0;
+	uint32_t checkSum      = 0;
+	uint64_t fileSize      = 0;
+	uint64_t headerHash    = 0;
+
+	bool isValid() const
+	{
+		return fileSize != 0;
+	}
+
+	bool operator==(const ImageIdentity& other) const
+	{
+		return timeDateStamp == other.timeDateStamp && sizeOfImage == other.sizeOfImage && checkSum == other.checkSum && fileSize == other.fileSize && headerHash == other.headerHash;
+	}
+};
+
+// Bytes at the start of the executable that have to be read for readImageIdentity, more than any PE header needs
+static constexpr size_t IMAGE_HEADER_READ_SIZE = 4096;
+
+// Fills the identity from the start of the executable file, returns false if it does not start with PE headers
+bool readImageIdentity(const uint8_t* pHeader, const size_t headerSize, const uint64_t fileSize, ImageIdentity& identity);
+
+//
+// Small file storing the RVA of every hooked function for one build of the game
+//
+namespace sigcache
+{
+static constexpr uint32_t MAGIC   = 0x43535245; // "ERSC"
+static constexpr uint32_t VERSION = 2;
+
+// Anything larger than this is not a cache written by us
+static constexpr uint32_t MAX_RVA_COUNT = 1024;
+
+struct Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t timeDateStamp;
+	uint32_t sizeOfImage;
+	uint32_t checkSum;
+	uint32_t rvaCount;
+	uint64_t fileSize;
+	uint64_t headerHash;
+};
+} // namespace sigcache
+
+// Returns false if the file is missing, damaged or belongs to a different build. Invalid identities are never cached.
+bool loadSignatureCache(const std::string& path, const ImageIdentity& identity, std::vector<uint32_t>& outRvas);
+bool saveSignatureCache(const std::string& path, const ImageIdentity& identity, const std::vector<uint32_t>& rvas);
@@ -0,0 +1,396 @@
+/*
+ *  File: SignatureScanner.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "SignatureScanner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define SIGNATURE_SCANNER_SIMD 1
+#else
+#define SIGNATURE_SCANNER_SIMD 0
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+// Wide enough for one AVX2 register
+static const size_t SIGNATURE_PADDING = 32;
+
+// Smallest amount of data handed to a worker thread at once
+static const size_t MIN_CHUNK_SIZE = 1024 * 1024;
+
+static int hexValue(const char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+
+	return -1;
+}
+
+bool Signature::parse(const std::string& pattern)
+{
+	bytes.clear();
+	mask.clear();
+	length = 0;
+
+	size_t pos = 0;
+
+	while (pos < pattern.size())
+	{
+		if (pattern[pos] == ' ')
+		{
+			pos++;
+			continue;
+		}
+
+		size_t end = pattern.find(' ', pos);
+		if (end == std::string::npos)
+			end = pattern.size();
+
+		const std::string token = pattern.substr(pos, end - pos);
+		pos                     = end;
+
+		if (token == "?" || token == "??")
+		{
+			bytes.push_back(0x00);
+			mask.push_back(0x00);
+		}
+		else if (token.size() == 2 && hexValue(token[0]) >= 0 && hexValue(token[1]) >= 0)
+		{
+			bytes.push_back(static_cast<uint8_t>(hexValue(token[0]) * 16 + hexValue(token[1])));
+			mask.push_back(0xFF);
+		}
+		else
+		{
+			bytes.clear();
+			mask.clear();
+			return false;
+		}
+	}
+
+	const auto first = std::find(mask.begin(), mask.end(), 0xFF);
+	if (first == mask.end())
+	{
+		bytes.clear();
+		mask.clear();
+		return false;
+	}
+
+	firstFixed = static_cast<size_t>(first - mask.begin());
+	lastFixed  = mask.size() - 1 - static_cast<size_t>(std::find(mask.rbegin(), mask.rend(), 0xFF) - mask.rbegin());
+	length     = bytes.size();
+
+	const size_t padded = (length + SIGNATURE_PADDING - 1) / SIGNATURE_PADDING * SIGNATURE_PADDING;
+	bytes.resize(padded, 0x00);
+	mask.resize(padded, 0x00);
+
+	return true;
+}
+
+#if SIGNATURE_SCANNER_SIMD
+static uint32_t lowestSetBit(const uint32_t value)
+{
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanForward(&idx, value);
+	return static_cast<uint32_t>(idx);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+static bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+	__cpuidex(info, 7, 0);
+	return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static const bool HAS_AVX2 = cpuHasAvx2();
+
+static bool matchesSse2(const uint8_t* pData, const Signature& signature)
+{
+	for (size_t i = 0; i < signature.bytes.size(); i += 16)
+	{
+		const __m128i data    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i));
+		const __m128i mask    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signature.mask.data() + i));
+		const __m128i pattern = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signature.bytes.data() + i));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, mask), pattern)) != 0xFFFF)
+			return false;
+	}
+
+	return true;
+}
+
+AVX2_TARGET static bool matchesAvx2(const uint8_t* pData, const Signature& signature)
+{
+	for (size_t i = 0; i < signature.bytes.size(); i += 32)
+	{
+		const __m256i data    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i));
+		const __m256i mask    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(signature.mask.data() + i));
+		const __m256i pattern = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(signature.bytes.data() + i));
+
+		if (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, mask), pattern))) != 0xFFFFFFFF)
+			return false;
+	}
+
+	return true;
+}
+#endif
+
+uint32_t SignatureScanner::add(const std::string& pattern)
+{
+	Signature signature;
+	signature.parse(pattern);
+
+	m_signatures.push_back(std::move(signature));
+	m_results.push_back(NOT_FOUND);
+	m_remaining++;
+
+	return static_cast<uint32_t>(m_signatures.size() - 1);
+}
+
+void SignatureScanner::reset()
+{
+	std::fill(m_results.begin(), m_results.end(), NOT_FOUND);
+	m_remaining = m_signatures.size();
+}
+
+bool SignatureScanner::accept(const uint32_t id, const uint8_t* pData, const size_t size, const size_t offset, const size_t baseOffset)
+{
+	if (m_results[id] != NOT_FOUND)
+		return m_results[id] == baseOffset + offset;
+
+	const Signature& signature = m_signatures[id];
+
+	if (!signature.isValid() || offset > size || signature.length > size - offset || !matches(pData + offset, size - offset, id))
+		return false;
+
+	m_results[id] = baseOffset + offset;
+	m_remaining--;
+
+	return true;
+}
+
+bool SignatureScanner::allowAvx2(const bool allow)
+{
+	m_allowAvx2 = allow;
+
+#if SIGNATURE_SCANNER_SIMD
+	return HAS_AVX2 && m_allowAvx2;
+#else
+	return false;
+#endif
+}
+
+bool SignatureScanner::matches(const uint8_t* pData, const size_t available, const uint32_t id) const
+{
+	const Signature& signature = m_signatures[id];
+
+#if SIGNATURE_SCANNER_SIMD
+	// The vector compares read the padding as well, so they can only be used away from the end of the buffer
+	if (available >= signature.bytes.size())
+		return (HAS_AVX2 && m_allowAvx2) ? matchesAvx2(pData, signature) : matchesSse2(pData, signature);
+#else
+	(void)available;
+#endif
+
+	for (size_t i = 0; i < signature.length; i++)
+	{
+		if ((pData[i] & signature.mask[i]) != signature.bytes[i])
+			return false;
+	}
+
+	return true;
+}
+
+void SignatureScanner::scan(const uint8_t* pData, const size_t size, const size_t baseOffset)
+{
+	// Signatures still missing after the previous buffers, matching ones are removed while scanning
+	std::vector<uint32_t> active;
+	size_t longest = 0;
+
+	for (uint32_t id = 0; id < m_signatures.size(); id++)
+	{
+		if (m_results[id] != NOT_FOUND || !m_signatures[id].isValid() || m_signatures[id].length > size)
+			continue;
+
+		active.push_back(id);
+		longest = (std::max)(longest, m_signatures[id].length);
+	}
+
+	size_t pos = 0;
+
+#if SIGNATURE_SCANNER_SIMD
+	// Check the first and last fixed byte of every signature for 16 positions at once, only candidates are compared in full
+	while (!active.empty() && pos + 16 + longest - 1 <= size)
+	{
+		for (size_t a = 0; a < active.size();)
+		{
+			const uint32_t id          = active[a];
+			const Signature& signature = m_signatures[id];
+
+			const __m128i first = _mm_set1_epi8(static_cast<char>(signature.bytes[signature.firstFixed]));
+			const __m128i last  = _mm_set1_epi8(static_cast<char>(signature.bytes[signature.lastFixed]));
+
+			const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + pos + signature.firstFixed));
+			const __m128i blockLast  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + pos + signature.lastFixed));
+
+			uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+			bool found          = false;
+
+			while (candidates != 0)
+			{
+				const uint32_t bit = lowestSetBit(candidates);
+
+				if (matches(pData + pos + bit, size - pos - bit, id))
+				{
+					m_results[id] = baseOffset + pos + bit;
+					found         = true;
+					break;
+				}
+
+				candidates &= candidates - 1;
+			}
+
+			if (found)
+			{
+				m_remaining--;
+				active.erase(active.begin() + a);
+			}
+			else
+				a++;
+		}
+
+		pos += 16;
+	}
+#endif
+
+	// Remaining positions near the end of the buffer
+	for (; !active.empty() && pos < size; pos++)
+	{
+		for (size_t a = 0; a < active.size();)
+		{
+			const uint32_t id          = active[a];
+			const Signature& signature = m_signatures[id];
+
+			if (pos + signature.length <= size && pData[pos + signature.firstFixed] == signature.bytes[signature.firstFixed] && matches(pData + pos, size - pos, id))
+			{
+				m_results[id] = baseOffset + pos;
+				m_remaining--;
+				active.erase(active.begin() + a);
+			}
+			else
+				a++;
+		}
+	}
+}
+
+void SignatureScanner::scanParallel(const uint8_t* pData, const size_t size, const size_t baseOffset, const uint32_t threadCount)
+{
+	size_t longest = 0;
+	for (const Signature& signature : m_signatures)
+		longest = (std::max)(longest, signature.length);
+
+	// A few chunks per thread, so threads finishing early can pick up more work
+	const size_t chunkSize  = (std::max)(MIN_CHUNK_SIZE, size / (static_cast<size_t>(threadCount) * 4 + 1));
+	const size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+
+	if (threadCount <= 1 || chunkCount <= 1 || longest == 0)
+	{
+		scan(pData, size, baseOffset);
+		return;
+	}
+
+	std::atomic<size_t> nextChunk = 0;
+	std::mutex resultsMutex;
+	std::vector<size_t> results = m_results;
+
+	auto worker = [&]()
+	{
+		size_t chunk;
+
+		while ((chunk = nextChunk.fetch_add(1)) < chunkCount)
+		{
+			// Chunks overlap by the longest signature, so matches crossing a chunk border are found as well
+			const size_t start = chunk * chunkSize;
+			const size_t end   = (std::min)(size, start + chunkSize + longest - 1);
+
+			SignatureScanner local = *this;
+			local.scan(pData + start, end - start, baseOffset + start);
+
+			// Keep the earliest match, just like a sequential scan would
+			std::lock_guard<std::mutex> lock(resultsMutex);
+
+			for (uint32_t id = 0; id < results.size(); id++)
+			{
+				if (m_results[id] == NOT_FOUND && local.m_results[id] != NOT_FOUND)
+					results[id] = (std::min)(results[id], local.m_results[id]);
+			}
+		}
+	};
+
+	const uint32_t workerCount = static_cast<uint32_t>((std::min)(static_cast<size_t>(threadCount), chunkCount));
+	std::vector<std::thread> threads;
+
+	for (uint32_t i = 1; i < workerCount; i++)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	m_results   = std::move(results);
+	m_remaining = static_cast<size_t>(std::count(m_results.begin(), m_results.end(), NOT_FOUND));
+}
@@ -0,0 +1,112 @@
+/*
+ *  File: SignatureScanner.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// Byte signature with optional wildcards, parsed from IDA style text like "48 8B 05 ?? ??"
+//
+struct Signature
+{
+	// Bytes are stored pre-masked and padded with wildcards to a multiple of SIGNATURE_PADDING
+	std::vector<uint8_t> bytes;
+	std::vector<uint8_t> mask;
+	size_t length = 0;
+
+	// First and last byte that is not a wildcard, used to prefilter candidates
+	size_t firstFixed = 0;
+	size_t lastFixed  = 0;
+
+	// Returns false if the text is not a valid pattern or only consists of wildcards
+	bool parse(const std::string& pattern);
+
+	bool isValid() const
+	{
+		return length != 0;
+	}
+};
+
+//
+// Searches a buffer for several byte signatures at once.
+// Works on plain memory, the caller decides which parts of an image are scanned.
+//
+class SignatureScanner
+{
+public:
+	static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+	SignatureScanner() = default;
+
+	// Returns the id used to query the result of this signature, invalid patterns are never found
+	uint32_t add(const std::string& pattern);
+
+	// Forgets all results, the signatures are kept
+	void reset();
+
+	// Accepts a previously resolved offset if the signature still matches there, offset is relative to pData
+	bool accept(const uint32_t id, const uint8_t* pData, const size_t size, const size_t offset, const size_t baseOffset = 0);
+
+	// Scans the buffer, offsets of new matches are reported relative to baseOffset.
+	// Only the first match of each signature is kept, so buffers should be passed in ascending order.
+	void scan(const uint8_t* pData, const size_t size, const size_t baseOffset = 0);
+
+	// Same results as scan, but the buffer is split into overlapping chunks that are scanned by threadCount threads.
+	// Must not be called while the loader lock is held, the worker threads could not start.
+	void scanParallel(const uint8_t* pData, const size_t size, const size_t baseOffset, const uint32_t threadCount);
+
+	size_t result(const uint32_t id) const
+	{
+		return m_results[id];
+	}
+
+	size_t size() const
+	{
+		return m_signatures.size();
+	}
+
+	bool allFound() const
+	{
+		return m_remaining == 0;
+	}
+
+	// Full matches use AVX2 if the CPU supports it and it is allowed, returns whether AVX2 is used
+	bool allowAvx2(const bool allow);
+
+private:
+	// available is the number of readable bytes at pData, at least the length of the signature
+	bool matches(const uint8_t* pData, const size_t available, const uint32_t id) const;
+
+private:
+	std::vector<Signature> m_signatures;
+	std::vector<size_t> m_results;
+	size_t m_remaining = 0;
+	bool m_allowAvx2   = true;
+};
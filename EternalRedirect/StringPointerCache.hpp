@@ -0,0 +1,105 @@
+/*
+ *  File: StringPointerCache.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//
+// Direct mapped cache from string addresses inside a read-only section to lookup results.
+// The game passes most strings straight from its .rdata section, so the same address always holds the same
+// content and repeated calls can skip hashing and comparing. Each slot packs the section offset and the
+// cached value into one 64 bit word, so concurrent readers never observe a torn entry.
+//
+class StringPointerCache
+{
+public:
+	void init(const void* pSectionStart, const size_t sectionSize)
+	{
+		m_start = reinterpret_cast<uintptr_t>(pSectionStart);
+		m_size  = sectionSize;
+		clear();
+	}
+
+	void clear()
+	{
+		for (std::atomic<uint64_t>& slot : m_slots)
+			slot.store(0, std::memory_order_relaxed);
+	}
+
+	bool covers(const void* pStr) const
+	{
+		return (reinterpret_cast<uintptr_t>(pStr) - m_start) < m_size;
+	}
+
+	// Returns true if a value for this address is cached, the meaning of the value is up to the caller
+	bool get(const void* pStr, uint32_t& outValue) const
+	{
+		if (!covers(pStr))
+			return false;
+
+		const uint64_t tag   = tagOf(pStr);
+		const uint64_t value = m_slots[slotOf(tag)].load(std::memory_order_relaxed);
+
+		if ((value >> 32) != tag)
+			return false;
+
+		outValue = static_cast<uint32_t>(value);
+		return true;
+	}
+
+	// Addresses outside of the section are ignored
+	void put(const void* pStr, const uint32_t value)
+	{
+		if (!covers(pStr))
+			return;
+
+		const uint64_t tag = tagOf(pStr);
+		m_slots[slotOf(tag)].store((tag << 32) | value, std::memory_order_relaxed);
+	}
+
+private:
+	static constexpr size_t SLOT_COUNT = 8192;
+
+	// Offset + 1 so that an empty slot never matches
+	uint64_t tagOf(const void* pStr) const
+	{
+		return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pStr) - m_start) + 1;
+	}
+
+	static size_t slotOf(const uint64_t tag)
+	{
+		return static_cast<size_t>((tag * 0x9E3779B97F4A7C15ull) >> 51) & (SLOT_COUNT - 1);
+	}
+
+private:
+	uintptr_t m_start = 0;
+	size_t m_size     = 0;
+
+	std::atomic<uint64_t> m_slots[SLOT_COUNT] = {};
+};
@@ -0,0 +1,159 @@
+/*
+ *  File: TranslationHooks.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "TranslationHooks.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+//
+// Format a translated format string with the arguments of the original one.
+// Returns a negative value if the result does not fit.
+//
+static int formatTemplate(char* pBuffer, const size_t bufferSize, const char* pTemplate, va_list args)
+{
+#ifdef _MSC_VER
+	// Only the positional printf variants of the CRT understand reordered arguments like %2$s
+	if (strchr(pTemplate, '$') != nullptr)
+	{
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+		const int length = _vscprintf_p(pTemplate, argsCopy);
+		va_end(argsCopy);
+
+		if (length < 0 || static_cast<size_t>(length) >= bufferSize)
+			return -1;
+
+		return _vsprintf_p(pBuffer, bufferSize, pTemplate, args);
+	}
+#endif
+
+	const int length = vsnprintf(pBuffer, bufferSize, pTemplate, args);
+	if (length < 0 || static_cast<size_t>(length) >= bufferSize)
+		return -1;
+
+	return length;
+}
+
+char* copyTranslation(TranslationSnapshot* pSnapshot, const char* pStr, ScratchBuffer& scratch, stats::HookScope& scope, TranslationEntry* pLargest, size_t& outLength)
+{
+	TranslationView entry;
+
+	// Check if this string exists in the translations
+	if (!findTranslation(pSnapshot, pStr, entry))
+	{
+		scope.miss();
+		return nullptr;
+	}
+
+	scope.hit(entry.text.size());
+
+	// The widest line of every entry is determined when the table is built
+	if (pLargest != nullptr && entry.pWidestLine != nullptr && (pLargest->generation != pSnapshot->generation || *pLargest < entry.widestPixelLength))
+		*pLargest = TranslationEntry(entry.pWidestLine, entry.widestPixelLength, pSnapshot->generation);
+
+	outLength = entry.text.size();
+	return scratch.copy(entry.text);
+}
+
+const char* widthString(TranslationSnapshot* pSnapshot, const char* pFormat, stats::HookScope& scope, TranslationEntry& largest)
+{
+	TranslationView entry;
+
+	// Check if this string exists in the translations
+	if (!findTranslation(pSnapshot, pFormat, entry))
+	{
+		scope.miss();
+		return pFormat;
+	}
+
+	scope.hit(entry.text.size());
+
+	const char* pStr = entry.text.data();
+
+	// This should only have a single entry so just take the first -- Maybe expand later if needed
+	const uint32_t pixelLength = entry.pixelLengths.empty() ? 0 : entry.pixelLengths[0];
+
+	// Now determine which is the largest string, lines copied before a reload point into a table that might be gone
+	if (largest.generation == pSnapshot->generation && largest > pixelLength)
+		pStr = largest.pText;
+
+	// Clear the largest string since resize after using it
+	largest.clear();
+
+	return pStr;
+}
+
+const char* drawString(TranslationSnapshot* pSnapshot, const char* pFormat, va_list args, char* pBuffer, const size_t bufferSize, stats::HookScope& scope, TranslationEntry& largest)
+{
+	largest.clear();
+
+	// Look up the format string itself first, this also covers templates like "%d damage"
+	const StringInfo info = lookupString(pSnapshot, pFormat);
+
+	// Without any conversion the format string is identical to its output
+	if (!info.hasConversions)
+	{
+		if (info.entry == TranslationTable::NPOS)
+		{
+			scope.miss();
+			return pFormat;
+		}
+
+		scope.hit(pSnapshot->table.text(info.entry).size());
+		return pSnapshot->table.text(info.entry).data();
+	}
+
+	if (info.entry != TranslationTable::NPOS)
+	{
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+		const int length = formatTemplate(pBuffer, bufferSize, pSnapshot->table.text(info.entry).data(), argsCopy);
+		va_end(argsCopy);
+
+		if (length >= 0)
+		{
+			scope.hit(static_cast<size_t>(length));
+			return pBuffer;
+		}
+
+		// The translated template did not fit, show the original text instead
+	}
+
+	vsnprintf(pBuffer, bufferSize, pFormat, args);
+
+	TranslationView entry;
+
+	// Check if the formatted string exists in the translations
+	if (pSnapshot != nullptr && pSnapshot->table.lookup(pBuffer, entry))
+	{
+		scope.hit(entry.text.size());
+		return entry.text.data();
+	}
+
+	scope.miss();
+	return pBuffer;
+}
@@ -0,0 +1,80 @@
+/*
+ *  File: TranslationHooks.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+#include "HookStats.hpp"
+#include "TranslationLookup.hpp"
+
+struct TranslationEntry
+{
+	TranslationEntry() = default;
+	TranslationEntry(const char* t, const uint32_t& pl, const uint64_t& gen) :
+		pText(t), pixelLength(pl), generation(gen) {}
+
+	// Null terminated line in the translation table of the given snapshot generation
+	const char* pText    = nullptr;
+	uint32_t pixelLength = 0;
+	uint64_t generation  = 0;
+
+	void clear()
+	{
+		pText       = nullptr;
+		pixelLength = 0;
+	}
+
+	bool operator<(const uint32_t& other) const
+	{
+		return pixelLength < other;
+	}
+
+	bool operator>(const uint32_t& other) const
+	{
+		return pixelLength > other;
+	}
+};
+
+//
+// Bodies of the detoured functions without any call into the game, shared by the hooks and the tests.
+// The hooks hold the stats scope and an epoch::ReadGuard, look up the current snapshot and pass the
+// returned string to the game. pSnapshot may be nullptr while the translations are still loading.
+// largest is the widest line copied since the last draw, GetDrawFormatStringWidth measures it instead.
+//
+
+// CopyFunc and CopyEnemyNameFunc: returns the translation of pStr copied to the scratch buffer, nullptr if there is none
+char* copyTranslation(TranslationSnapshot* pSnapshot, const char* pStr, ScratchBuffer& scratch, stats::HookScope& scope, TranslationEntry* pLargest, size_t& outLength);
+
+// GetDrawFormatStringWidth: returns the string to measure and clears largest
+const char* widthString(TranslationSnapshot* pSnapshot, const char* pFormat, stats::HookScope& scope, TranslationEntry& largest);
+
+//
+// DrawFormatVStringToHandle: returns the string to draw. That is the translation of the format string, the translated
+// template formatted with args, or the translation of the formatted original. Formatted strings are written to pBuffer.
+//
+const char* drawString(TranslationSnapshot* pSnapshot, const char* pFormat, va_list args, char* pBuffer, const size_t bufferSize, stats::HookScope& scope, TranslationEntry& largest);
@@ -0,0 +1,199 @@
+/*
+ *  File: TranslationLoader.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "TranslationLoader.hpp"
+
+#include <string_view>
+
+#include "Cp932.hpp"
+#include "FontMetrics.hpp"
+#include "FormatString.hpp"
+#include "JsonReader.hpp"
+#include "MappedFile.hpp"
+
+bool loadTranslationsJson(const std::string& path, TranslationTableBuilder& builder, std::vector<TranslationSchemaError>* pErrors, const FontMetrics* pFont)
+{
+	MappedFile file;
+	if (!file.open(path))
+		return false;
+
+	JsonReader reader(reinterpret_cast<const char*>(file.data()), file.size());
+
+	const auto reportError = [pErrors](const size_t offset, const std::string& key, const char* pMessage) {
+		if (pErrors)
+			pErrors->push_back({ offset, key, pMessage });
+	};
+
+	// Reused for every entry so parsing does not allocate once they are large enough
+	std::string key;
+	std::string sjisKey;
+	std::string sjisText;
+	std::string utf8Text;
+	std::vector<uint32_t> pixelLengths;
+	std::vector<uint32_t> measuredLengths;
+
+	reader.expect('{');
+
+	if (!reader.consume('}'))
+	{
+		do
+		{
+			const size_t entryOffset = reader.offset();
+			key.assign(reader.readString());
+			reader.expect(':');
+
+			if (key == WINDOW_TITLE_KEY && reader.peek() == '"')
+			{
+				builder.setWindowTitle(reader.readString());
+				continue;
+			}
+
+			if (reader.peek() != '{')
+			{
+				reportError(reader.offset(), key, "entry is not an object");
+				reader.skipValue();
+				continue;
+			}
+
+			bool hasText   = false;
+			bool hasLength = false;
+			bool valid     = true;
+
+			reader.expect('{');
+
+			if (!reader.consume('}'))
+			{
+				do
+				{
+					const std::string_view field = reader.readString();
+
+					if (field == "text")
+					{
+						reader.expect(':');
+
+						if (reader.peek() != '"')
+						{
+							reportError(reader.offset(), key, "\"text\" is not a string");
+							reader.skipValue();
+							valid = false;
+							continue;
+						}
+
+						const std::string_view text = reader.readString();
+
+						// Only measured once the object closes and it turns out to have no pixel lengths
+						if (pFont != nullptr)
+							utf8Text.assign(text);
+
+						sjisText.clear();
+						cp932::appendSjis(text, sjisText);
+						hasText = true;
+					}
+					else if (field == "pixel_lengths")
+					{
+						reader.expect(':');
+
+						if (reader.peek() != '[')
+						{
+							reportError(reader.offset(), key, "\"pixel_lengths\" is not an array");
+							reader.skipValue();
+							valid = false;
+							continue;
+						}
+
+						reader.expect('[');
+						pixelLengths.clear();
+
+						if (!reader.consume(']'))
+						{
+							do
+							{
+								const size_t valueOffset = reader.offset();
+								uint32_t length          = 0;
+
+								if (reader.peek() != '-' && (reader.peek() < '0' || reader.peek() > '9'))
+								{
+									reportError(valueOffset, key, "\"pixel_lengths\" contains a value that is not a number");
+									reader.skipValue();
+									valid = false;
+								}
+								else if (!reader.readUInt32(length))
+								{
+									reportError(valueOffset, key, "\"pixel_lengths\" contains a value that is not an unsigned 32 bit integer");
+									valid = false;
+								}
+								else
+									pixelLengths.push_back(length);
+							} while (reader.consume(','));
+
+							reader.expect(']');
+						}
+
+						hasLength = true;
+					}
+					else
+					{
+						reader.expect(':');
+						reader.skipValue();
+					}
+				} while (reader.consume(','));
+
+				reader.expect('}');
+			}
+
+			if (!valid)
+				continue;
+
+			if (!hasText || (!hasLength && pFont == nullptr))
+			{
+				reportError(entryOffset, key, hasText ? "missing \"pixel_lengths\"" : "missing \"text\"");
+				continue;
+			}
+
+			sjisKey.clear();
+			cp932::appendSjis(key, sjisKey);
+
+			// The hooks format the text with the game's arguments whenever the key is a format string
+			if (!isCompatibleFormat(sjisKey, sjisText))
+			{
+				reportError(entryOffset, key, "\"text\" does not use the same format conversions as the key");
+				continue;
+			}
+
+			if (!hasLength)
+				pFont->lineWidths(utf8Text, measuredLengths);
+
+			builder.insert(sjisKey, sjisText, hasLength ? pixelLengths : measuredLengths);
+		} while (reader.consume(','));
+
+		reader.expect('}');
+	}
+
+	if (!reader.atEnd())
+		reader.fail("unexpected data after the translations");
+
+	return true;
+}
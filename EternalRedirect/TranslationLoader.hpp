@@ -0,0 +1,60 @@
+/*
+ *  File: TranslationLoader.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "TranslationTable.hpp"
+
+static const std::string WINDOW_TITLE_KEY = "window_title";
+
+// Font and size scripts/fix.py measures the lines with, used for entries without pixel lengths
+static const std::string FONT_FILE = "mplus-1c-medium.ttf";
+static const uint32_t FONT_SIZE    = 16;
+
+class FontMetrics;
+
+//
+// Entry of tr.json that was skipped because it does not have the expected layout
+//
+struct TranslationSchemaError
+{
+	// Byte offset of the entry or of the offending value within the file
+	size_t offset = 0;
+	std::string key;
+	std::string message;
+};
+
+//
+// Streams a tr.json file straight from a file mapping into the builder, no JSON document is built.
+// Keys and texts are converted to Shift-JIS so the hooks can work on the game strings directly.
+// Entries with a wrong layout are skipped and reported in pErrors if given.
+// If a font is given, entries without "pixel_lengths" are measured with it instead of being skipped.
+// Returns false if the file can not be opened, throws std::runtime_error with the byte offset on syntax errors.
+//
+bool loadTranslationsJson(const std::string& path, TranslationTableBuilder& builder, std::vector<TranslationSchemaError>* pErrors = nullptr, const FontMetrics* pFont = nullptr);
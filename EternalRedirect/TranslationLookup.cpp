@@ -0,0 +1,75 @@
+/*
+ *  File: TranslationLookup.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "TranslationLookup.hpp"
+
+// Layout of the values stored in the .rdata cache
+static constexpr uint32_t CACHE_CONVERSIONS_FLAG = 0x80000000;
+static constexpr uint32_t CACHE_ENTRY_MASK       = 0x7FFFFFFF;
+
+StringInfo lookupString(TranslationSnapshot* pSnapshot, const char* pStr)
+{
+	StringInfo info;
+	uint32_t value = 0;
+
+	// Without a table nothing is translated, but the string might still need to be formatted
+	if (pSnapshot == nullptr)
+	{
+		info.hasConversions = strchr(pStr, '%') != nullptr;
+		return info;
+	}
+
+	if (pSnapshot->rdataCache.get(pStr, value))
+	{
+		const uint32_t entry = value & CACHE_ENTRY_MASK;
+		info.entry           = (entry == CACHE_ENTRY_MASK) ? TranslationTable::NPOS : entry;
+		info.hasConversions  = (value & CACHE_CONVERSIONS_FLAG) != 0;
+		return info;
+	}
+
+	const std::string_view str = pStr;
+	info.entry                 = pSnapshot->table.find(str);
+	info.hasConversions        = str.find('%') != std::string_view::npos;
+
+	value = (info.entry == TranslationTable::NPOS) ? CACHE_ENTRY_MASK : info.entry;
+	if (info.hasConversions)
+		value |= CACHE_CONVERSIONS_FLAG;
+
+	pSnapshot->rdataCache.put(pStr, value);
+
+	return info;
+}
+
+bool findTranslation(TranslationSnapshot* pSnapshot, const char* pStr, TranslationView& outView)
+{
+	const StringInfo info = lookupString(pSnapshot, pStr);
+
+	if (info.entry == TranslationTable::NPOS)
+		return false;
+
+	outView = pSnapshot->table.view(info.entry);
+	return true;
+}
@@ -0,0 +1,86 @@
+/*
+ *  File: TranslationLookup.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "StringPointerCache.hpp"
+#include "TranslationTable.hpp"
+
+//
+// Translation table together with everything derived from it, replaced as a whole on reload
+//
+struct TranslationSnapshot
+{
+	TranslationTable table;
+	StringPointerCache rdataCache;
+	uint64_t generation = 0;
+};
+
+//
+// Per thread buffer for strings that have to be handed to the game as writable or null terminated memory.
+// It only grows, so once warmed up the hooks do not allocate anymore.
+//
+class ScratchBuffer
+{
+public:
+	char* copy(const std::string_view& str)
+	{
+		if (str.size() + 1 > m_data.size())
+			m_data.resize((std::max)(str.size() + 1, m_data.size() * 2));
+
+		memcpy(m_data.data(), str.data(), str.size());
+		m_data[str.size()] = '\0';
+
+		return m_data.data();
+	}
+
+private:
+	std::vector<char> m_data;
+};
+
+//
+// Result of looking up a string as it was passed by the game
+//
+struct StringInfo
+{
+	uint32_t entry      = TranslationTable::NPOS;
+	bool hasConversions = false;
+};
+
+//
+// Content lookup with the cache for strings from the game's .rdata section in front of it.
+// Also records whether the string contains a '%', so format strings are only scanned once.
+// pSnapshot may be nullptr while the translations are still loading.
+//
+StringInfo lookupString(TranslationSnapshot* pSnapshot, const char* pStr);
+
+bool findTranslation(TranslationSnapshot* pSnapshot, const char* pStr, TranslationView& outView);
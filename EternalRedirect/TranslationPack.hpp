@@ -0,0 +1,104 @@
+/*
+ *  File: TranslationPack.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+//
+// Binary layout of a compiled translation pack (tr.pack).
+// The same layout is used for tables built in memory from tr.json, so a pack can be used straight from a file mapping.
+// All offsets are relative to the start of the pack, all values are little endian.
+//
+namespace pack
+{
+static constexpr uint32_t MAGIC   = 0x50545245; // "ERTP"
+static constexpr uint32_t VERSION = 5;
+
+// Every section starts on a 16 byte boundary
+static constexpr uint32_t SECTION_ALIGNMENT = 16;
+
+struct Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t entryCount;
+
+	// Hash index, slotCount is always a power of two
+	uint32_t slotCount;
+	uint32_t slotsOffset;
+
+	// All entries back to back, see Entry
+	uint32_t entriesOffset;
+	uint32_t entriesSize;
+
+	// Null terminated window title, passed to the game as is
+	uint32_t windowTitleOffset;
+	uint32_t windowTitleLength;
+	uint32_t hasWindowTitle;
+
+	uint32_t totalSize;
+};
+
+// entry is the offset of the Entry record relative to the start of the entries section
+struct Slot
+{
+	uint32_t hashTag;
+	uint32_t entry;
+};
+
+static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+//
+// Per entry record, directly followed by the Shift-JIS key, the null terminated Shift-JIS text
+// and, aligned to ENTRY_ALIGNMENT, pixelCount uint32_t pixel lengths.
+// If the widest line is not the last line of the text a null terminated copy of it follows the pixel lengths.
+// Keeping everything of an entry together means a lookup only touches the slot and the entry.
+//
+struct Entry
+{
+	uint32_t keyLength;
+	uint32_t textLength;
+	uint32_t pixelCount;
+
+	// Line with the largest pixel length, the first one on ties. The offset is relative to the record
+	// and points to a null terminated string, it is only valid if pixelCount is not 0.
+	uint32_t widestLineOffset;
+	uint32_t widestPixelLength;
+};
+
+static constexpr uint32_t ENTRY_ALIGNMENT = 4;
+
+// Entry offsets are stored in 31 bits by the hooks, so the entries section has to stay below 2 GiB
+static constexpr uint32_t MAX_ENTRIES_SIZE = 0x7FFFFFFF;
+
+inline uint32_t pixelsOffset(const Entry& entry)
+{
+	const uint32_t offset = static_cast<uint32_t>(sizeof(Entry)) + entry.keyLength + entry.textLength + 1;
+	return (offset + ENTRY_ALIGNMENT - 1) & ~(ENTRY_ALIGNMENT - 1);
+}
+} // namespace pack
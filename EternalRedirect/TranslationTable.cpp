@@ -0,0 +1,474 @@
+/*
+ *  File: TranslationTable.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "TranslationTable.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "Cp932.hpp"
+
+static constexpr size_t MIN_CAPACITY = 16;
+
+static constexpr pack::Slot EMPTY_SLOT = { 0, pack::EMPTY_SLOT };
+
+// Keys with characters in a non canonical form up to this length are folded on the stack during lookups
+static constexpr size_t FOLD_BUFFER_SIZE = 1024;
+
+// Keep the load factor at or below 50% so that nearly every lookup resolves in the first slot
+static size_t capacityFor(const size_t count)
+{
+	size_t capacity = MIN_CAPACITY;
+	while (capacity < count * 2)
+		capacity <<= 1;
+
+	return capacity;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// TranslationTableBuilder
+//
+
+void TranslationTableBuilder::clear()
+{
+	m_slots.clear();
+	m_mask = 0;
+
+	m_hashes.clear();
+	m_keyOffsets.clear();
+	m_keyLengths.clear();
+	m_textOffsets.clear();
+	m_textLengths.clear();
+	m_pixelOffsets.clear();
+	m_pixelCounts.clear();
+
+	m_keyArena.clear();
+	m_textArena.clear();
+	m_pixelArena.clear();
+
+	m_windowTitle.clear();
+	m_hasWindowTitle = false;
+}
+
+void TranslationTableBuilder::reserve(size_t count)
+{
+	m_hashes.reserve(count);
+	m_keyOffsets.reserve(count);
+	m_keyLengths.reserve(count);
+	m_textOffsets.reserve(count);
+	m_textLengths.reserve(count);
+	m_pixelOffsets.reserve(count);
+	m_pixelCounts.reserve(count);
+
+	const size_t capacity = capacityFor(count);
+	if (capacity > m_slots.size())
+		rehash(capacity);
+}
+
+void TranslationTableBuilder::insert(std::string_view key, std::string_view text, const std::vector<uint32_t>& pixelLengths)
+{
+	if (m_slots.empty() || (size() + 1) * 2 > m_slots.size())
+		rehash(capacityFor(size() + 1));
+
+	const size_t foldOffset = cp932::findNonCanonical(key);
+	if (foldOffset != std::string_view::npos)
+	{
+		m_foldedKey.assign(key);
+		cp932::canonicalize(m_foldedKey.data(), m_foldedKey.size(), foldOffset);
+		key = m_foldedKey;
+	}
+
+	const uint64_t hash = hashBytes(key.data(), key.size());
+	const uint32_t slot = findSlot(key, hash);
+	uint32_t idx        = m_slots[slot].entry;
+
+	if (idx == pack::EMPTY_SLOT)
+	{
+		idx = static_cast<uint32_t>(size());
+
+		m_hashes.push_back(hash);
+		m_keyOffsets.push_back(static_cast<uint32_t>(m_keyArena.size()));
+		m_keyLengths.push_back(static_cast<uint32_t>(key.size()));
+		m_keyArena.append(key);
+
+		m_textOffsets.push_back(0);
+		m_textLengths.push_back(0);
+		m_pixelOffsets.push_back(0);
+		m_pixelCounts.push_back(0);
+
+		m_slots[slot] = { hashTag(hash), idx };
+	}
+
+	// Replaced values are not reclaimed, duplicate keys are rare enough for this not to matter
+	m_textOffsets[idx] = static_cast<uint32_t>(m_textArena.size());
+	m_textLengths[idx] = static_cast<uint32_t>(text.size());
+	m_textArena.append(text);
+	m_textArena.push_back('\0');
+
+	m_pixelOffsets[idx] = static_cast<uint32_t>(m_pixelArena.size());
+	m_pixelCounts[idx]  = static_cast<uint32_t>(pixelLengths.size());
+	m_pixelArena.insert(m_pixelArena.end(), pixelLengths.begin(), pixelLengths.end());
+}
+
+void TranslationTableBuilder::setWindowTitle(std::string_view title)
+{
+	m_windowTitle    = title;
+	m_hasWindowTitle = true;
+}
+
+std::vector<uint8_t> TranslationTableBuilder::build() const
+{
+	std::vector<uint8_t> out(sizeof(pack::Header), 0);
+
+	const auto appendSection = [&out](const void* pData, const size_t size) {
+		out.resize((out.size() + pack::SECTION_ALIGNMENT - 1) & ~static_cast<size_t>(pack::SECTION_ALIGNMENT - 1), 0);
+
+		const uint32_t offset = static_cast<uint32_t>(out.size());
+		if (size > 0)
+			out.insert(out.end(), static_cast<const uint8_t*>(pData), static_cast<const uint8_t*>(pData) + size);
+
+		return offset;
+	};
+
+	// Lay out all entries in one arena and point the slots at their records instead of the builder indices
+	std::vector<uint32_t> entryOffsets(size());
+	std::vector<uint8_t> entries;
+	entries.reserve(m_keyArena.size() + m_textArena.size() + m_pixelArena.size() * sizeof(uint32_t) + size() * (sizeof(pack::Entry) + pack::ENTRY_ALIGNMENT));
+
+	for (size_t idx = 0; idx < size(); idx++)
+	{
+		const std::string_view text = std::string_view(m_textArena.data() + m_textOffsets[idx], m_textLengths[idx]);
+		const uint32_t* pPixels     = m_pixelArena.data() + m_pixelOffsets[idx];
+
+		pack::Entry entry = { m_keyLengths[idx], m_textLengths[idx], m_pixelCounts[idx], 0, 0 };
+
+		// Pixel lengths belong to the lines in order, extra values without a matching line are ignored
+		size_t widestStart = 0;
+		size_t widestEnd   = text.size();
+		size_t lineStart   = 0;
+
+		for (uint32_t i = 0; i < entry.pixelCount; i++)
+		{
+			size_t lineEnd = text.find('\n', lineStart);
+			if (lineEnd == std::string_view::npos)
+				lineEnd = text.size();
+
+			if (i == 0 || pPixels[i] > entry.widestPixelLength)
+			{
+				entry.widestPixelLength = pPixels[i];
+				widestStart             = lineStart;
+				widestEnd               = lineEnd;
+			}
+
+			if (lineEnd == text.size())
+				break;
+
+			lineStart = lineEnd + 1;
+		}
+
+		// The last line is already null terminated, every other one gets its own copy
+		const uint32_t pixelsOffset = pack::pixelsOffset(entry);
+		const uint32_t pixelsEnd    = pixelsOffset + entry.pixelCount * static_cast<uint32_t>(sizeof(uint32_t));
+		const bool copyWidestLine   = entry.pixelCount != 0 && widestEnd != text.size();
+
+		if (copyWidestLine)
+			entry.widestLineOffset = pixelsEnd;
+		else
+			entry.widestLineOffset = static_cast<uint32_t>(sizeof(pack::Entry) + entry.keyLength + widestStart);
+
+		size_t entrySize = pixelsEnd + (copyWidestLine ? widestEnd - widestStart + 1 : 0);
+		entrySize        = (entrySize + pack::ENTRY_ALIGNMENT - 1) & ~static_cast<size_t>(pack::ENTRY_ALIGNMENT - 1);
+
+		const size_t offset = entries.size();
+		if (offset + entrySize > pack::MAX_ENTRIES_SIZE)
+			throw std::runtime_error("Translation entries exceed 2 GiB");
+
+		entryOffsets[idx] = static_cast<uint32_t>(offset);
+		entries.resize(offset + entrySize, 0);
+
+		uint8_t* pEntry = entries.data() + offset;
+		memcpy(pEntry, &entry, sizeof(entry));
+		memcpy(pEntry + sizeof(entry), m_keyArena.data() + m_keyOffsets[idx], entry.keyLength);
+		memcpy(pEntry + sizeof(entry) + entry.keyLength, text.data(), text.size());
+		if (entry.pixelCount != 0)
+			memcpy(pEntry + pixelsOffset, pPixels, entry.pixelCount * sizeof(uint32_t));
+
+		if (copyWidestLine)
+			memcpy(pEntry + pixelsEnd, text.data() + widestStart, widestEnd - widestStart);
+	}
+
+	std::vector<pack::Slot> slots = m_slots.empty() ? std::vector<pack::Slot>(MIN_CAPACITY, EMPTY_SLOT) : m_slots;
+	for (pack::Slot& slot : slots)
+	{
+		if (slot.entry != pack::EMPTY_SLOT)
+			slot.entry = entryOffsets[slot.entry];
+	}
+
+	pack::Header header = {};
+	header.magic        = pack::MAGIC;
+	header.version      = pack::VERSION;
+	header.headerSize   = sizeof(pack::Header);
+	header.entryCount   = static_cast<uint32_t>(size());
+
+	header.slotCount   = static_cast<uint32_t>(slots.size());
+	header.slotsOffset = appendSection(slots.data(), slots.size() * sizeof(pack::Slot));
+
+	header.entriesSize   = static_cast<uint32_t>(entries.size());
+	header.entriesOffset = appendSection(entries.data(), entries.size());
+
+	header.hasWindowTitle    = m_hasWindowTitle ? 1 : 0;
+	header.windowTitleLength = static_cast<uint32_t>(m_windowTitle.size());
+	header.windowTitleOffset = appendSection(m_windowTitle.c_str(), m_windowTitle.size() + 1);
+
+	if (out.size() > UINT32_MAX)
+		throw std::runtime_error("Translation pack exceeds 4 GiB");
+
+	header.totalSize = static_cast<uint32_t>(out.size());
+	memcpy(out.data(), &header, sizeof(header));
+
+	return out;
+}
+
+void TranslationTableBuilder::rehash(size_t capacity)
+{
+	m_slots.assign(capacity, EMPTY_SLOT);
+	m_mask = capacity - 1;
+
+	for (uint32_t idx = 0; idx < static_cast<uint32_t>(size()); idx++)
+	{
+		size_t slot = static_cast<size_t>(m_hashes[idx]) & m_mask;
+		while (m_slots[slot].entry != pack::EMPTY_SLOT)
+			slot = (slot + 1) & m_mask;
+
+		m_slots[slot] = { hashTag(m_hashes[idx]), idx };
+	}
+}
+
+//
+// Linear probing, the stored hash tag filters out almost all key comparisons of colliding entries.
+// Returns either the slot holding the key or the empty slot where it would be inserted.
+//
+uint32_t TranslationTableBuilder::findSlot(std::string_view key, const uint64_t hash) const
+{
+	const uint32_t tag = hashTag(hash);
+	size_t slot        = static_cast<size_t>(hash) & m_mask;
+
+	while (true)
+	{
+		const pack::Slot& s = m_slots[slot];
+
+		if (s.entry == pack::EMPTY_SLOT)
+			return static_cast<uint32_t>(slot);
+
+		if (s.hashTag == tag && m_keyLengths[s.entry] == key.size() && memcmp(m_keyArena.data() + m_keyOffsets[s.entry], key.data(), key.size()) == 0)
+			return static_cast<uint32_t>(slot);
+
+		slot = (slot + 1) & m_mask;
+	}
+}
+
+//
+// The DLL keeps tr.pack mapped, so it cannot be truncated or overwritten while the game runs.
+// The pack is written next to the target and renamed over it, if the target is still mapped it is moved aside first.
+//
+void writePackFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+	const std::filesystem::path target    = path;
+	const std::filesystem::path temporary = path + ".tmp";
+	const std::filesystem::path previous  = path + ".old";
+
+	std::ofstream file(path + ".tmp", std::ios::binary);
+	if (!file)
+		throw std::runtime_error("Failed to create file: " + path + ".tmp");
+
+	file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	file.close();
+
+	if (!file)
+	{
+		std::error_code ec;
+		std::filesystem::remove(temporary, ec);
+		throw std::runtime_error("Failed to write file: " + path + ".tmp");
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temporary, target, ec);
+	if (!ec)
+		return;
+
+	// A mapped file can still be renamed because the DLL opens it with FILE_SHARE_DELETE
+	std::filesystem::remove(previous, ec);
+	std::filesystem::rename(target, previous, ec);
+	if (!ec)
+	{
+		std::filesystem::rename(temporary, target, ec);
+		if (ec)
+		{
+			std::error_code restoreError;
+			std::filesystem::rename(previous, target, restoreError);
+		}
+	}
+
+	if (ec)
+	{
+		std::filesystem::remove(temporary, ec);
+		throw std::runtime_error("Failed to replace file: " + path);
+	}
+
+	// Fails as long as the DLL still maps the previous pack, it is replaced again on the next write
+	std::filesystem::remove(previous, ec);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// TranslationTable
+//
+
+void TranslationTable::clear()
+{
+	m_pData    = nullptr;
+	m_pHeader  = nullptr;
+	m_pSlots   = nullptr;
+	m_mask     = 0;
+	m_pEntries = nullptr;
+
+	m_ownedData.clear();
+	m_ownedData.shrink_to_fit();
+	m_file.close();
+}
+
+bool TranslationTable::load(std::vector<uint8_t>&& data)
+{
+	clear();
+
+	m_ownedData = std::move(data);
+	if (attach(m_ownedData.data(), m_ownedData.size()))
+		return true;
+
+	clear();
+	return false;
+}
+
+bool TranslationTable::map(const std::string& path)
+{
+	clear();
+
+	if (m_file.open(path) && attach(m_file.data(), m_file.size()))
+		return true;
+
+	clear();
+	return false;
+}
+
+bool TranslationTable::attach(const uint8_t* pData, const size_t size)
+{
+	if (size < sizeof(pack::Header))
+		return false;
+
+	const pack::Header* pHeader = reinterpret_cast<const pack::Header*>(pData);
+
+	if (pHeader->magic != pack::MAGIC || pHeader->version != pack::VERSION || pHeader->headerSize != sizeof(pack::Header))
+		return false;
+
+	if (pHeader->totalSize > size)
+		return false;
+
+	if (pHeader->slotCount == 0 || (pHeader->slotCount & (pHeader->slotCount - 1)) != 0)
+		return false;
+
+	const auto sectionValid = [pHeader](const uint32_t offset, const uint64_t bytes) {
+		return (offset % sizeof(uint32_t)) == 0 && static_cast<uint64_t>(offset) + bytes <= pHeader->totalSize;
+	};
+
+	if (!sectionValid(pHeader->slotsOffset, static_cast<uint64_t>(pHeader->slotCount) * sizeof(pack::Slot))
+		|| !sectionValid(pHeader->entriesOffset, pHeader->entriesSize)
+		|| !sectionValid(pHeader->windowTitleOffset, static_cast<uint64_t>(pHeader->windowTitleLength) + 1))
+		return false;
+
+	m_pData    = pData;
+	m_pHeader  = pHeader;
+	m_pSlots   = reinterpret_cast<const pack::Slot*>(pData + pHeader->slotsOffset);
+	m_mask     = pHeader->slotCount - 1;
+	m_pEntries = pData + pHeader->entriesOffset;
+
+	return true;
+}
+
+uint32_t TranslationTable::find(std::string_view key) const
+{
+	if (m_pSlots == nullptr)
+		return NPOS;
+
+	const size_t foldOffset = cp932::findNonCanonical(key);
+	if (foldOffset != std::string_view::npos)
+		return findFolded(key, foldOffset);
+
+	const uint64_t hash = hashBytes(key.data(), key.size());
+	const uint32_t tag  = hashTag(hash);
+	uint32_t slot       = static_cast<uint32_t>(hash) & m_mask;
+
+	// Bounded so that a damaged pack without empty slots can not stall the game
+	for (uint32_t i = 0; i <= m_mask; i++)
+	{
+		const pack::Slot& s = m_pSlots[slot];
+
+		if (s.entry == NPOS)
+			return NPOS;
+
+		if (s.hashTag == tag)
+		{
+			const pack::Entry* pEntry = record(s.entry);
+			if (pEntry->keyLength == key.size() && memcmp(pEntry + 1, key.data(), key.size()) == 0)
+				return s.entry;
+		}
+
+		slot = (slot + 1) & m_mask;
+	}
+
+	return NPOS;
+}
+
+//
+// The game may use any form of a character that exists more than once, the keys are stored in the form cp932::toSjis produces.
+// Long keys use a per thread buffer that only grows, so lookups stay free of allocations once it is large enough.
+//
+uint32_t TranslationTable::findFolded(std::string_view key, const size_t foldOffset) const
+{
+	char stackBuffer[FOLD_BUFFER_SIZE];
+	char* pBuffer = stackBuffer;
+
+	if (key.size() > sizeof(stackBuffer))
+	{
+		thread_local std::string t_foldBuffer;
+		t_foldBuffer.assign(key);
+		pBuffer = t_foldBuffer.data();
+	}
+	else
+		memcpy(pBuffer, key.data(), key.size());
+
+	cp932::canonicalize(pBuffer, key.size(), foldOffset);
+	return find(std::string_view(pBuffer, key.size()));
+}
@@ -0,0 +1,263 @@
+/*
+ *  File: TranslationTable.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "TranslationPack.hpp"
+
+//
+// Hash used for all translation keys, processes 8 bytes per round
+//
+inline uint64_t hashBytes(const char* pData, size_t length)
+{
+	constexpr uint64_t MUL_1 = 0x87C37B91114253D5ull;
+	constexpr uint64_t MUL_2 = 0x4CF5AD432745937Full;
+
+	uint64_t h = 0x9E3779B97F4A7C15ull ^ (length * MUL_2);
+
+	while (length >= 8)
+	{
+		uint64_t w;
+		memcpy(&w, pData, 8);
+		h ^= w * MUL_1;
+		h = ((h << 31) | (h >> 33)) * MUL_2;
+		pData += 8;
+		length -= 8;
+	}
+
+	if (length > 0)
+	{
+		uint64_t w = 0;
+		memcpy(&w, pData, length);
+		h ^= w * MUL_1;
+		h = ((h << 31) | (h >> 33)) * MUL_2;
+	}
+
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDull;
+	h ^= h >> 33;
+
+	return h;
+}
+
+// The upper half of the hash is stored in each slot, the lower half selects the slot
+inline uint32_t hashTag(const uint64_t hash)
+{
+	return static_cast<uint32_t>(hash >> 32);
+}
+
+//
+// Read-only view of the pixel lengths stored for a single entry
+//
+struct PixelLengths
+{
+	const uint32_t* pData = nullptr;
+	uint32_t count        = 0;
+
+	const uint32_t* begin() const { return pData; }
+	const uint32_t* end() const { return pData + count; }
+	bool empty() const { return count == 0; }
+	uint32_t operator[](const uint32_t idx) const { return pData[idx]; }
+};
+
+//
+// Borrowed view of a single entry, stays valid as long as the table it came from
+//
+struct TranslationView
+{
+	// Shift-JIS text, always followed by a null terminator
+	std::string_view text     = {};
+	PixelLengths pixelLengths = {};
+
+	// Null terminated line of the text with the largest pixel length, nullptr if there are no pixel lengths
+	const char* pWidestLine    = nullptr;
+	uint32_t widestPixelLength = 0;
+};
+
+//
+// Collects translations and serializes them into the pack layout described in TranslationPack.hpp.
+// Used when loading tr.json at runtime and by the offline pack compiler.
+//
+class TranslationTableBuilder
+{
+public:
+	TranslationTableBuilder() = default;
+
+	void clear();
+	void reserve(size_t count);
+
+	// Adds or replaces the entry for the given key, characters with several forms are folded like in TranslationTable::find
+	void insert(std::string_view key, std::string_view text, const std::vector<uint32_t>& pixelLengths);
+	void setWindowTitle(std::string_view title);
+
+	size_t size() const
+	{
+		return m_hashes.size();
+	}
+
+	std::vector<uint8_t> build() const;
+
+private:
+	void rehash(size_t capacity);
+	uint32_t findSlot(std::string_view key, const uint64_t hash) const;
+
+private:
+	std::vector<pack::Slot> m_slots;
+	size_t m_mask = 0;
+
+	std::vector<uint64_t> m_hashes;
+	std::vector<uint32_t> m_keyOffsets;
+	std::vector<uint32_t> m_keyLengths;
+	std::vector<uint32_t> m_textOffsets;
+	std::vector<uint32_t> m_textLengths;
+	std::vector<uint32_t> m_pixelOffsets;
+	std::vector<uint32_t> m_pixelCounts;
+
+	std::string m_keyArena;
+	std::string m_textArena;
+	std::vector<uint32_t> m_pixelArena;
+
+	std::string m_windowTitle;
+	bool m_hasWindowTitle = false;
+
+	std::string m_foldedKey;
+};
+
+// Writes a pack so that a running game which maps the previous one picks up the change, throws std::runtime_error on failure
+void writePackFile(const std::string& path, const std::vector<uint8_t>& data);
+
+//
+// Open addressing hash table mapping translation keys to their text and pixel lengths.
+// All entries live in a single arena, each one is a small record followed by its key, text and pixel lengths.
+// Keys and texts are stored as raw Shift-JIS bytes, exactly as the game passes them to the hooks.
+// The table is immutable, it either owns a buffer created by TranslationTableBuilder or maps a compiled pack.
+//
+class TranslationTable
+{
+public:
+	static constexpr uint32_t NPOS = pack::EMPTY_SLOT;
+
+	TranslationTable() = default;
+
+	TranslationTable(const TranslationTable&)            = delete;
+	TranslationTable& operator=(const TranslationTable&) = delete;
+
+	void clear();
+
+	// Takes ownership of a buffer returned by TranslationTableBuilder::build
+	bool load(std::vector<uint8_t>&& data);
+
+	// Maps a compiled pack, only the header is validated so the remaining pages are read on demand
+	bool map(const std::string& path);
+
+	// Returns the entry with the given key or NPOS. Entries are offsets into the arena and always fit into 31 bits.
+	// Every form of a character that exists more than once finds the same entry, see cp932::canonicalize.
+	uint32_t find(std::string_view key) const;
+
+	// Looks up the key and fills the view on a hit, never allocates
+	bool lookup(std::string_view key, TranslationView& outView) const
+	{
+		const uint32_t idx = find(key);
+		if (idx == NPOS)
+			return false;
+
+		outView = view(idx);
+		return true;
+	}
+
+	TranslationView view(const uint32_t entry) const
+	{
+		const pack::Entry* pEntry = record(entry);
+		const char* pWidestLine   = pEntry->pixelCount != 0 ? reinterpret_cast<const char*>(pEntry) + pEntry->widestLineOffset : nullptr;
+
+		return { text(entry), pixelLengths(entry), pWidestLine, pEntry->widestPixelLength };
+	}
+
+	std::string_view key(const uint32_t entry) const
+	{
+		const pack::Entry* pEntry = record(entry);
+		return std::string_view(reinterpret_cast<const char*>(pEntry + 1), pEntry->keyLength);
+	}
+
+	// The returned view is always followed by a null terminator
+	std::string_view text(const uint32_t entry) const
+	{
+		const pack::Entry* pEntry = record(entry);
+		return std::string_view(reinterpret_cast<const char*>(pEntry + 1) + pEntry->keyLength, pEntry->textLength);
+	}
+
+	PixelLengths pixelLengths(const uint32_t entry) const
+	{
+		const pack::Entry* pEntry = record(entry);
+		return { reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(pEntry) + pack::pixelsOffset(*pEntry)), pEntry->pixelCount };
+	}
+
+	bool hasWindowTitle() const
+	{
+		return m_pHeader != nullptr && m_pHeader->hasWindowTitle != 0;
+	}
+
+	const char* windowTitle() const
+	{
+		return reinterpret_cast<const char*>(m_pData) + m_pHeader->windowTitleOffset;
+	}
+
+	size_t size() const
+	{
+		return m_pHeader ? m_pHeader->entryCount : 0;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+private:
+	bool attach(const uint8_t* pData, const size_t size);
+	uint32_t findFolded(std::string_view key, const size_t foldOffset) const;
+
+	const pack::Entry* record(const uint32_t entry) const
+	{
+		return reinterpret_cast<const pack::Entry*>(m_pEntries + entry);
+	}
+
+private:
+	std::vector<uint8_t> m_ownedData;
+	MappedFile m_file;
+
+	const uint8_t* m_pData        = nullptr;
+	const pack::Header* m_pHeader = nullptr;
+	const pack::Slot* m_pSlots    = nullptr;
+	uint32_t m_mask               = 0;
+	const uint8_t* m_pEntries     = nullptr;
+};
@@ -30,105 +30,80 @@
 #include <vector>
 #include <windows.h>
 
-std::string sjis2utf8(const char* sjis)
+//
+// PE headers of a loaded module, nullptr if the module does not look like a PE image
+//
+inline const IMAGE_NT_HEADERS* getNtHeaders(HMODULE hModule)
 {
-	int len = MultiByteToWideChar(932, 0, sjis, -1, NULL, 0);
-	std::wstring wstr;
-	wstr.resize(len);
-	MultiByteToWideChar(932, 0, sjis, -1, &wstr[0], len);
-
-	len = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, NULL, 0, NULL, NULL);
-	std::string utf8;
-	utf8.resize(len);
-	WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &utf8[0], len, NULL, NULL);
+	const BYTE* pBase                  = reinterpret_cast<const BYTE*>(hModule);
+	const IMAGE_DOS_HEADER* pDosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(pBase);
 
-	// Remove the null terminator added by WideCharToMultiByte
-	if (!utf8.empty() && utf8.back() == '\0')
-		utf8.pop_back();
+	if (pDosHeader->e_magic != IMAGE_DOS_SIGNATURE)
+		return nullptr;
 
-	return utf8;
-}
-
-std::string utf82sjis(const std::string& utf8)
-{
-	int len = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, NULL, 0);
-	std::wstring wstr;
-	wstr.resize(len);
-	MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wstr[0], len);
+	const IMAGE_NT_HEADERS* pNtHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(pBase + pDosHeader->e_lfanew);
 
-	len = WideCharToMultiByte(932, 0, wstr.c_str(), -1, NULL, 0, NULL, NULL);
-	std::string sjis;
-	sjis.resize(len);
-	WideCharToMultiByte(932, 0, wstr.c_str(), -1, &sjis[0], len, NULL, NULL);
+	if (pNtHeaders->Signature != IMAGE_NT_SIGNATURE)
+		return nullptr;
 
-	// Remove the null terminator added by WideCharToMultiByte
-	if (!sjis.empty() && sjis.back() == '\0')
-		sjis.pop_back();
-
-	return sjis;
+	return pNtHeaders;
 }
 
-std::string replaceAll(const std::string& str, const std::string& from, const std::string& to)
+//
+// Locate a section of a loaded module using its PE headers
+//
+inline bool getModuleSection(HMODULE hModule, const std::string& sectionName, const BYTE*& pOutStart, size_t& outSize)
 {
-	std::string result = str;
-	size_t start_pos   = 0;
-	while ((start_pos = result.find(from, start_pos)) != std::string::npos)
-	{
-		result.replace(start_pos, from.length(), to);
-		start_pos += to.length(); // Move past the replacement
-	}
+	const BYTE* pBase                  = reinterpret_cast<const BYTE*>(hModule);
+	const IMAGE_NT_HEADERS* pNtHeaders = getNtHeaders(hModule);
 
-	return result;
-}
+	if (pNtHeaders == nullptr)
+		return false;
 
-std::vector<std::string> splitString(const std::string& str, const char& delimiter = '\n')
-{
-	std::vector<std::string> tokens;
-	size_t start = 0;
-	size_t end   = str.find(delimiter);
+	const IMAGE_SECTION_HEADER* pSection = IMAGE_FIRST_SECTION(pNtHeaders);
 
-	while (end != std::string::npos)
+	for (WORD i = 0; i < pNtHeaders->FileHeader.NumberOfSections; i++, pSection++)
 	{
-		tokens.push_back(str.substr(start, end - start));
-		start = end + 1;
-		end   = str.find(delimiter, start);
+		const std::string secName = std::string(reinterpret_cast<const char*>(pSection->Name), strnlen_s(reinterpret_cast<const char*>(pSection->Name), IMAGE_SIZEOF_SHORT_NAME));
+		if (secName == sectionName)
+		{
+			pOutStart = pBase + pSection->VirtualAddress;
+			outSize   = pSection->Misc.VirtualSize;
+			return true;
+		}
 	}
 
-	tokens.push_back(str.substr(start));
-	return tokens;
+	return false;
 }
 
 //
-// Determine the offset for the given function
+// Collect all executable sections of a loaded module, in the order of the section table
 //
-uintptr_t findFunction(const std::vector<BYTE>& tarBytes)
+struct ModuleSection
 {
-	const uintptr_t startAddress = reinterpret_cast<uintptr_t>(GetModuleHandleW(nullptr));
-	MEMORY_BASIC_INFORMATION info;
-	uintptr_t endAddress = startAddress;
+	const BYTE* pStart = nullptr;
+	size_t size        = 0;
+};
 
-	do
-	{
-		VirtualQuery((void*)endAddress, &info, sizeof(info));
-		endAddress = (uintptr_t)info.BaseAddress + info.RegionSize;
-	} while (info.Protect > PAGE_NOACCESS);
+inline std::vector<ModuleSection> getExecutableSections(HMODULE hModule)
+{
+	std::vector<ModuleSection> sections;
+
+	const BYTE* pBase                  = reinterpret_cast<const BYTE*>(hModule);
+	const IMAGE_NT_HEADERS* pNtHeaders = getNtHeaders(hModule);
 
-	endAddress -= info.RegionSize;
+	if (pNtHeaders == nullptr)
+		return sections;
 
-	const DWORD procMemLength = static_cast<DWORD>(endAddress - startAddress);
-	const DWORD tarLength     = static_cast<DWORD>(tarBytes.size());
-	const BYTE* pProcData     = reinterpret_cast<BYTE*>(startAddress);
+	const IMAGE_SECTION_HEADER* pSection = IMAGE_FIRST_SECTION(pNtHeaders);
 
-	for (DWORD i = 0; i < procMemLength - tarLength; i++)
+	for (WORD i = 0; i < pNtHeaders->FileHeader.NumberOfSections; i++, pSection++)
 	{
-		for (DWORD j = 0; j <= tarLength; j++)
-		{
-			if (j == tarLength)
-				return startAddress + i;
-			else if (pProcData[i + j] != tarBytes[j])
-				break;
-		}
+		if ((pSection->Characteristics & IMAGE_SCN_MEM_EXECUTE) == 0)
+			continue;
+
+		sections.push_back({ pBase + pSection->VirtualAddress, pSection->Misc.VirtualSize });
 	}
 
-	return static_cast<uintptr_t>(-1);
+	return sections;
 }
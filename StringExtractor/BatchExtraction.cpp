@@ -0,0 +1,276 @@
+/*
+ *  File: BatchExtraction.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "BatchExtraction.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include "../EternalRedirect/JsonWriter.hpp"
+#include "../EternalRedirect/TranslationTable.hpp"
+
+// Strings of a batch version that are not in the version before it and the other way around
+static void writeDiff(const std::string& base, const std::vector<std::string_view>& added, const std::vector<std::string_view>& removed, std::ostream& stream)
+{
+	JsonWriter writer(stream);
+
+	writer.beginObject();
+	writer.key("base");
+	writer.string(base);
+
+	writer.key("added");
+	writer.beginArray();
+	for (const std::string_view string : added)
+		writer.string(string);
+	writer.endArray();
+
+	writer.key("removed");
+	writer.beginArray();
+	for (const std::string_view string : removed)
+		writer.string(string);
+	writer.endArray();
+
+	writer.endObject();
+}
+
+//
+// Same result as groupStrings over all sections of the version, built from the strings of each section.
+// A string first found in an earlier section stays in front, its locations are appended in section order.
+//
+static std::vector<ExtractedString> versionStrings(const BatchVersion& version, const std::vector<DataSection>& uniqueSections, const std::vector<std::vector<ExtractedString>>& sectionTexts)
+{
+	std::vector<ExtractedString> result;
+	std::unordered_map<std::string_view, uint32_t> textIndex;
+
+	for (uint32_t sectionIdx = 0; sectionIdx < version.sections.size(); sectionIdx++)
+	{
+		const uint32_t id = version.sectionIds[sectionIdx];
+
+		// Shared sections have the same bytes, but can be loaded at a different address
+		const uint32_t rvaDelta = version.sections[sectionIdx].rva - uniqueSections[id].rva;
+
+		for (const ExtractedString& string : sectionTexts[id])
+		{
+			const auto [it, inserted] = textIndex.emplace(string.text, static_cast<uint32_t>(result.size()));
+			if (inserted)
+				result.push_back({ string.text, {} });
+
+			for (const StringLocation& location : string.locations)
+				result[it->second].locations.push_back({ sectionIdx, location.rva + rvaDelta, location.length });
+		}
+	}
+
+	return result;
+}
+
+static std::ofstream createFile(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+		throw std::runtime_error("Failed to create file: " + path);
+
+	return file;
+}
+
+std::vector<DataSection> shareSections(std::vector<BatchVersion>& versions)
+{
+	std::vector<std::pair<uint32_t, uint32_t>> allSections;
+	for (uint32_t i = 0; i < versions.size(); i++)
+	{
+		for (uint32_t j = 0; j < versions[i].sections.size(); j++)
+			allSections.emplace_back(i, j);
+	}
+
+	std::vector<uint64_t> hashes(allSections.size());
+
+	parallelFor(allSections.size(), [&](const size_t idx) {
+		const std::string_view data = versions[allSections[idx].first].sections[allSections[idx].second].data;
+		hashes[idx]                 = hashBytes(data.data(), data.size());
+	});
+
+	// Sections with the same hash are only shared if their bytes are equal as well
+	std::unordered_map<uint64_t, std::vector<uint32_t>> sectionIndex;
+	std::vector<DataSection> uniqueSections;
+
+	for (BatchVersion& version : versions)
+		version.sectionIds.clear();
+
+	for (size_t i = 0; i < allSections.size(); i++)
+	{
+		BatchVersion& version      = versions[allSections[i].first];
+		const DataSection& section = version.sections[allSections[i].second];
+
+		std::vector<uint32_t>& candidates = sectionIndex[hashes[i]];
+		const auto it                     = std::find_if(candidates.begin(), candidates.end(), [&](const uint32_t id) { return uniqueSections[id].data == section.data; });
+
+		if (it != candidates.end())
+			version.sectionIds.push_back(*it);
+		else
+		{
+			candidates.push_back(static_cast<uint32_t>(uniqueSections.size()));
+			version.sectionIds.push_back(candidates.back());
+			uniqueSections.push_back(section);
+		}
+	}
+
+	return uniqueSections;
+}
+
+BatchResult extractBatch(std::vector<BatchVersion>& versions, const std::string& directory)
+{
+	BatchResult result;
+
+	if (versions.empty())
+		return result;
+
+	const std::vector<DataSection> uniqueSections = shareSections(versions);
+
+	for (const BatchVersion& version : versions)
+		result.sectionCount += version.sections.size();
+
+	result.uniqueSectionCount = uniqueSections.size();
+
+	const std::vector<std::vector<StringRef>> sectionStrings = extractSections(uniqueSections);
+
+	std::vector<std::vector<ExtractedString>> sectionTexts(uniqueSections.size());
+
+	parallelFor(uniqueSections.size(), [&](const size_t idx) {
+		sectionTexts[idx] = groupStrings({ uniqueSections[idx] }, { sectionStrings[idx] });
+	});
+
+	// The first version is written exactly like a single extraction
+	{
+		const BatchVersion& version                = versions.front();
+		const std::vector<ExtractedString> strings = versionStrings(version, uniqueSections, sectionTexts);
+
+		const std::string jsonPath      = (std::filesystem::path(directory) / (version.name + ".json")).string();
+		const std::string locationsPath = (std::filesystem::path(directory) / (version.name + "_locations.json")).string();
+
+		std::ofstream jsonFile      = createFile(jsonPath);
+		std::ofstream locationsFile = createFile(locationsPath);
+
+		writeStrings(strings, jsonFile);
+		writeLocations(version.sections, strings, locationsFile);
+
+		BatchFile& file  = result.files.emplace_back();
+		file.path        = jsonPath;
+		file.stringCount = strings.size();
+	}
+
+	// Number of sections of the current version that contain each string
+	std::unordered_map<std::string_view, uint32_t> sectionCounts;
+
+	for (const uint32_t id : versions.front().sectionIds)
+	{
+		for (const ExtractedString& string : sectionTexts[id])
+			sectionCounts[string.text]++;
+	}
+
+	for (size_t i = 1; i < versions.size(); i++)
+	{
+		const BatchVersion& previous = versions[i - 1];
+		const BatchVersion& version  = versions[i];
+
+		// Sections only in the previous version are positive, sections only in this one negative
+		std::unordered_map<uint32_t, int32_t> sectionDelta;
+		for (const uint32_t id : previous.sectionIds)
+			sectionDelta[id]++;
+		for (const uint32_t id : version.sectionIds)
+			sectionDelta[id]--;
+
+		std::unordered_map<std::string_view, uint32_t> countsBefore;
+		std::vector<std::string_view> touched;
+		uint32_t changedSections = 0;
+
+		auto applySection = [&](const uint32_t id, const bool add)
+		{
+			for (const ExtractedString& string : sectionTexts[id])
+			{
+				uint32_t& count = sectionCounts[string.text];
+
+				if (countsBefore.emplace(string.text, count).second)
+					touched.push_back(string.text);
+
+				count = add ? count + 1 : count - 1;
+			}
+
+			changedSections++;
+		};
+
+		for (const uint32_t id : previous.sectionIds)
+		{
+			if (sectionDelta[id] > 0)
+			{
+				sectionDelta[id]--;
+				applySection(id, false);
+			}
+		}
+
+		for (const uint32_t id : version.sectionIds)
+		{
+			if (sectionDelta[id] < 0)
+			{
+				sectionDelta[id]++;
+				applySection(id, true);
+			}
+		}
+
+		std::vector<std::string_view> added;
+		std::vector<std::string_view> removed;
+
+		for (const std::string_view string : touched)
+		{
+			const uint32_t before = countsBefore[string];
+			const uint32_t after  = sectionCounts[string];
+
+			if (before == 0 && after != 0)
+				added.push_back(string);
+			else if (before != 0 && after == 0)
+				removed.push_back(string);
+
+			if (after == 0)
+				sectionCounts.erase(string);
+		}
+
+		const std::string diffPath = (std::filesystem::path(directory) / (version.name + "_diff.json")).string();
+
+		std::ofstream diffFile = createFile(diffPath);
+		writeDiff(previous.path, added, removed, diffFile);
+
+		BatchFile& file      = result.files.emplace_back();
+		file.path            = diffPath;
+		file.stringCount     = sectionCounts.size();
+		file.addedCount      = added.size();
+		file.removedCount    = removed.size();
+		file.changedSections = changedSections;
+	}
+
+	return result;
+}
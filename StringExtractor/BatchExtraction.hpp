@@ -0,0 +1,77 @@
+/*
+ *  File: BatchExtraction.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SectionStrings.hpp"
+
+//
+// Executable of a batch run, sections with the same contents share their id across all versions
+//
+struct BatchVersion
+{
+	std::string path;
+	std::string name;
+	std::vector<DataSection> sections;
+	std::vector<uint32_t> sectionIds;
+};
+
+//
+// Output file of a batch run. The first version lists its strings, every other one the diff to the version before.
+//
+struct BatchFile
+{
+	std::string path;
+	size_t stringCount     = 0;
+	size_t addedCount      = 0;
+	size_t removedCount    = 0;
+	size_t changedSections = 0;
+};
+
+struct BatchResult
+{
+	size_t sectionCount       = 0;
+	size_t uniqueSectionCount = 0;
+	std::vector<BatchFile> files;
+};
+
+// Sets the section ids of all versions, sections share an id only if their bytes are equal. Returns the section of each id.
+std::vector<DataSection> shareSections(std::vector<BatchVersion>& versions);
+
+//
+// Extracts the strings of several builds of the game in one run. Sections are identified by the hash of
+// their contents, so a section shared by several builds is scanned and converted only once, with all
+// builds sharing the same worker threads. The first build is written in full, like a single extraction.
+// Every other build gets a diff against the build before it, computed only from the sections that differ
+// between the two, while a count of sections per string tracks which strings exist in the current build.
+// The files are named after the versions and written into directory.
+// Throws std::runtime_error if a file can not be written.
+//
+BatchResult extractBatch(std::vector<BatchVersion>& versions, const std::string& directory);
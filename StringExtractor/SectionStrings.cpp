@@ -0,0 +1,203 @@
+/*
+ *  File: SectionStrings.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "SectionStrings.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "../EternalRedirect/JsonWriter.hpp"
+
+// Sections are split into chunks of about this size, so large sections are scanned by several threads
+static const size_t CHUNK_SIZE = 1024 * 1024;
+
+void parallelFor(const size_t count, const std::function<void(const size_t)>& func)
+{
+	std::atomic<size_t> next = 0;
+
+	auto worker = [&]()
+	{
+		size_t idx;
+
+		while ((idx = next.fetch_add(1)) < count)
+			func(idx);
+	};
+
+	const uint32_t threadCount = static_cast<uint32_t>((std::min)(static_cast<size_t>((std::max)(1u, std::thread::hardware_concurrency())), count));
+	std::vector<std::thread> threads;
+
+	for (uint32_t i = 1; i < threadCount; i++)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+//
+// Sections are cut into chunks right after a zero byte, where the scanner starts over anyway,
+// so the result is the same as scanning every section at once
+//
+std::vector<std::vector<StringRef>> extractSections(const std::vector<DataSection>& sections)
+{
+	struct Chunk
+	{
+		uint32_t section = 0;
+		size_t begin     = 0;
+		size_t end       = 0;
+	};
+
+	std::vector<Chunk> chunks;
+
+	for (uint32_t i = 0; i < sections.size(); i++)
+	{
+		const std::string_view data = sections[i].data;
+		size_t begin                = 0;
+
+		while (begin < data.size())
+		{
+			size_t end = (std::min)(begin + CHUNK_SIZE, data.size());
+
+			if (end < data.size())
+			{
+				const size_t zero = data.find('\0', end - 1);
+				end               = (zero == std::string_view::npos) ? data.size() : zero + 1;
+			}
+
+			chunks.push_back({ i, begin, end });
+			begin = end;
+		}
+	}
+
+	std::vector<std::vector<StringRef>> chunkStrings(chunks.size());
+
+	parallelFor(chunks.size(), [&](const size_t idx) {
+		const Chunk& chunk          = chunks[idx];
+		const std::string_view data = sections[chunk.section].data;
+
+		chunkStrings[idx] = extractStrings(reinterpret_cast<const uint8_t*>(data.data()) + chunk.begin, chunk.end - chunk.begin);
+
+		for (StringRef& string : chunkStrings[idx])
+			string.offset += static_cast<uint32_t>(chunk.begin);
+	});
+
+	std::vector<std::vector<StringRef>> strings(sections.size());
+
+	for (size_t i = 0; i < chunks.size(); i++)
+		strings[chunks[i].section].insert(strings[chunks[i].section].end(), chunkStrings[i].begin(), chunkStrings[i].end());
+
+	return strings;
+}
+
+//
+// Duplicates are found by their Shift-JIS bytes before anything is converted. Different byte sequences
+// that convert to the same UTF-8 text, like the NEC and IBM copies of some characters, are merged afterwards.
+//
+std::vector<ExtractedString> groupStrings(const std::vector<DataSection>& sections, const std::vector<std::vector<StringRef>>& strings)
+{
+	std::vector<ExtractedString> result;
+	std::unordered_map<std::string_view, uint32_t> sjisIndex;
+	std::unordered_map<std::string, uint32_t> utf8Index;
+	std::string utf8Str;
+
+	for (uint32_t sectionIdx = 0; sectionIdx < sections.size(); sectionIdx++)
+	{
+		const DataSection& section = sections[sectionIdx];
+
+		for (const StringRef& string : strings[sectionIdx])
+		{
+			const StringLocation location  = { sectionIdx, section.rva + string.offset, string.length };
+			const std::string_view sjisStr = section.data.substr(string.offset, string.length);
+
+			const auto sjisIt = sjisIndex.find(sjisStr);
+			if (sjisIt != sjisIndex.end())
+			{
+				result[sjisIt->second].locations.push_back(location);
+				continue;
+			}
+
+			utf8Str.clear();
+			cp932::appendUtf8(sjisStr, utf8Str);
+
+			const auto [utf8It, inserted] = utf8Index.emplace(utf8Str, static_cast<uint32_t>(result.size()));
+			if (inserted)
+				result.push_back({ utf8Str, {} });
+
+			sjisIndex.emplace(sjisStr, utf8It->second);
+			result[utf8It->second].locations.push_back(location);
+		}
+	}
+
+	return result;
+}
+
+void writeStrings(const std::vector<ExtractedString>& strings, std::ostream& stream)
+{
+	JsonWriter writer(stream);
+
+	writer.beginObject();
+
+	for (const ExtractedString& string : strings)
+	{
+		writer.key(string.text);
+		writer.string("");
+	}
+
+	writer.endObject();
+}
+
+void writeLocations(const std::vector<DataSection>& sections, const std::vector<ExtractedString>& strings, std::ostream& stream)
+{
+	JsonWriter writer(stream);
+
+	writer.beginObject();
+
+	for (const ExtractedString& string : strings)
+	{
+		writer.key(string.text);
+		writer.beginArray();
+
+		for (const StringLocation& location : string.locations)
+		{
+			writer.beginObject();
+			writer.key("section");
+			writer.string(sections[location.section].name);
+			writer.key("rva");
+			writer.number(location.rva);
+			writer.key("length");
+			writer.number(location.length);
+			writer.endObject();
+		}
+
+		writer.endArray();
+	}
+
+	writer.endObject();
+}
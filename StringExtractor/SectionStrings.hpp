@@ -0,0 +1,77 @@
+/*
+ *  File: SectionStrings.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "StringScanner.hpp"
+
+//
+// Initialized data section of the executable, data only covers the bytes that are loaded into memory
+//
+struct DataSection
+{
+	std::string name;
+	uint32_t rva = 0;
+	std::string_view data;
+};
+
+struct StringLocation
+{
+	uint32_t section = 0;
+	uint32_t rva     = 0;
+	uint32_t length  = 0;
+};
+
+//
+// Distinct string in UTF-8 with every place it was found at
+//
+struct ExtractedString
+{
+	std::string text;
+	std::vector<StringLocation> locations;
+};
+
+// Calls func for every index below count, the indices are handed out one by one to all cores
+void parallelFor(const size_t count, const std::function<void(const size_t)>& func);
+
+// Scans all sections in parallel, returns the strings per section
+std::vector<std::vector<StringRef>> extractSections(const std::vector<DataSection>& sections);
+
+// Merges all occurrences of a string, in the order of their first occurrence
+std::vector<ExtractedString> groupStrings(const std::vector<DataSection>& sections, const std::vector<std::vector<StringRef>>& strings);
+
+// Every string with an empty translation, the input for scripts/fix.py and TrFixer
+void writeStrings(const std::vector<ExtractedString>& strings, std::ostream& stream);
+
+// Sidecar with the section, RVA and Shift-JIS byte length of every occurrence of each string
+void writeLocations(const std::vector<DataSection>& sections, const std::vector<ExtractedString>& strings, std::ostream& stream);
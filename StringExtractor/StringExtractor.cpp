@@ -25,119 +25,160 @@
  */
 
 #include <Windows.h>
+#include <algorithm>
+#include <deque>
 #include <exception>
+#include <filesystem>
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <string_view>
 #include <vector>
 
-#include <nlohmann/json.hpp>
+#include "../EternalRedirect/MappedFile.hpp"
+#include "BatchExtraction.hpp"
+#include "SectionStrings.hpp"
+#include "TranslationMerge.hpp"
 
-#include "../EternalRedirect/Utils.hpp"
+static const std::string OUTPUT_FILE    = "output.json";
+static const std::string LOCATIONS_FILE = "output_locations.json";
 
-const std::string TARGET_SECTION_NAME = ".rdata";
+static const std::string MERGE_OPTION = "--merge";
+static const std::string BATCH_OPTION = "--batch";
 
-IMAGE_SECTION_HEADER getRDataSection(std::ifstream& file)
+// Returns all sections with initialized data that is not code, in the order of the section table
+std::vector<DataSection> getDataSections(const MappedFile& file)
 {
-	IMAGE_DOS_HEADER dosHeader;
-	file.read(reinterpret_cast<char*>(&dosHeader), sizeof(dosHeader));
+	const uint8_t* pData = file.data();
+	const size_t size    = file.size();
 
-	if (dosHeader.e_magic != IMAGE_DOS_SIGNATURE)
+	if (size < sizeof(IMAGE_DOS_HEADER))
+		throw std::runtime_error("File is too small for a DOS header");
+
+	const IMAGE_DOS_HEADER* pDosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(pData);
+
+	if (pDosHeader->e_magic != IMAGE_DOS_SIGNATURE)
 		throw std::runtime_error("Invalid DOS header signature");
 
-	file.seekg(dosHeader.e_lfanew);
-	IMAGE_NT_HEADERS64 ntHeaders;
-	file.read(reinterpret_cast<char*>(&ntHeaders), sizeof(ntHeaders));
+	if (pDosHeader->e_lfanew < 0 || static_cast<size_t>(pDosHeader->e_lfanew) + sizeof(IMAGE_NT_HEADERS64) > size)
+		throw std::runtime_error("Invalid NT header offset");
 
-	if (ntHeaders.Signature != IMAGE_NT_SIGNATURE)
+	const IMAGE_NT_HEADERS64* pNtHeaders = reinterpret_cast<const IMAGE_NT_HEADERS64*>(pData + pDosHeader->e_lfanew);
+
+	if (pNtHeaders->Signature != IMAGE_NT_SIGNATURE)
 		throw std::runtime_error("Invalid NT header signature");
 
-	IMAGE_SECTION_HEADER sectionHeader;
-	bool found = false;
+	const IMAGE_SECTION_HEADER* pSections = IMAGE_FIRST_SECTION(pNtHeaders);
+	const uint16_t sectionCount           = pNtHeaders->FileHeader.NumberOfSections;
 
-	for (uint32_t i = 0; i < ntHeaders.FileHeader.NumberOfSections; i++)
-	{
-		file.read(reinterpret_cast<char*>(&sectionHeader), sizeof(sectionHeader));
+	if (reinterpret_cast<const uint8_t*>(pSections + sectionCount) > pData + size)
+		throw std::runtime_error("Section table exceeds the file");
 
-		const std::string secName = std::string(reinterpret_cast<char*>(sectionHeader.Name), strnlen_s(reinterpret_cast<char*>(sectionHeader.Name), IMAGE_SIZEOF_SHORT_NAME));
-		if (secName == TARGET_SECTION_NAME)
-			return sectionHeader;
-	}
+	std::vector<DataSection> sections;
 
-	throw std::runtime_error("Target section not found");
-}
+	for (uint16_t i = 0; i < sectionCount; i++)
+	{
+		const IMAGE_SECTION_HEADER& sec = pSections[i];
 
-std::vector<char> getRData(const std::string& filename)
-{
-	std::ifstream file(filename, std::ios::binary);
+		if (!(sec.Characteristics & IMAGE_SCN_CNT_INITIALIZED_DATA) || (sec.Characteristics & (IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE)))
+			continue;
 
-	if (!file)
-		throw std::runtime_error(std::format("Failed to open file: {}", filename));
+		// The raw data is padded to the file alignment, only the first VirtualSize bytes are loaded
+		const size_t dataPtr = (std::min)(static_cast<size_t>(sec.PointerToRawData), size);
+		size_t dataSize      = (std::min)(static_cast<size_t>(sec.SizeOfRawData), size - dataPtr);
 
-	std::cout << "Getting rdata section information ... " << std::flush;
-	IMAGE_SECTION_HEADER sec = getRDataSection(file);
-	const DWORD dataPtr      = sec.PointerToRawData;
-	const DWORD dataSize     = sec.SizeOfRawData;
-	std::cout << "Done" << std::endl;
+		if (sec.Misc.VirtualSize != 0)
+			dataSize = (std::min)(dataSize, static_cast<size_t>(sec.Misc.VirtualSize));
 
-	std::cout << "Reading section data ... " << std::flush;
-	std::vector<char> secData;
-	secData.resize(dataSize);
+		const char* pName = reinterpret_cast<const char*>(sec.Name);
 
-	// Read the section data
-	file.seekg(dataPtr);
-	file.read(secData.data(), dataSize);
-	file.close();
-	std::cout << "Done" << std::endl;
+		DataSection& section = sections.emplace_back();
+		section.name.assign(pName, strnlen_s(pName, IMAGE_SIZEOF_SHORT_NAME));
+		section.rva  = sec.VirtualAddress;
+		section.data = std::string_view(reinterpret_cast<const char*>(pData) + dataPtr, dataSize);
+	}
 
-	return secData;
+	return sections;
 }
 
-bool isValidSJisString(const std::vector<char>& data)
+// Opens every executable of a batch run and writes its files into the working directory
+void runBatch(const std::vector<std::string>& paths)
 {
-	std::vector<char> validEscapeChars;
-	validEscapeChars.push_back('\n'); // Newline
-	validEscapeChars.push_back('\t'); // Tab
-	validEscapeChars.push_back('\r'); // Carriage return
+	std::deque<MappedFile> files;
+	std::vector<BatchVersion> versions;
 
-	for (char byte : data)
-	{
-		// Check for valid single-byte characters
-		if ((byte >= 0x20 && byte <= 0x7F) || (byte >= static_cast<char>(0xA1) && byte <= static_cast<char>(0xDF)))
-			continue;
+	std::cout << "Getting data sections ... " << std::flush;
 
-		// Check for valid escape sequences
-		if (std::find(validEscapeChars.begin(), validEscapeChars.end(), byte) != validEscapeChars.end())
-			continue;
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		BatchVersion& version = versions.emplace_back();
+		version.path          = paths[i];
+		version.name          = std::format("{}_{}", i + 1, std::filesystem::path(version.path).stem().string());
 
-		// Check for valid lead bytes of double-byte characters
-		if ((byte >= static_cast<char>(0x81) && byte <= static_cast<char>(0x9F)) || (byte >= static_cast<char>(0xE0) && byte <= static_cast<char>(0xFC)))
-			continue;
+		if (!files.emplace_back().open(version.path))
+			throw std::runtime_error(std::format("Failed to open file: {}", version.path));
 
-		return false;
+		version.sections = getDataSections(files.back());
+		if (version.sections.empty())
+			throw std::runtime_error(std::format("No initialized data sections found in {}", version.path));
 	}
 
-	return true;
-}
+	std::cout << "Done" << std::endl;
 
-bool isPureAsciiString(const std::vector<char>& data)
-{
-	for (char byte : data)
+	std::cout << "Extracting strings from section data ... " << std::flush;
+	const BatchResult result = extractBatch(versions, "");
+	std::cout << "Done" << std::endl;
+
+	std::cout << std::format("Versions: {}, sections: {}, unique sections: {}", versions.size(), result.sectionCount, result.uniqueSectionCount) << std::endl;
+
+	for (size_t i = 0; i < result.files.size(); i++)
 	{
-		if (static_cast<unsigned char>(byte) > 0x7F)
-			return false;
+		const BatchFile& file = result.files[i];
+
+		if (i == 0)
+			std::cout << std::format("  {}: {} unique strings", file.path, file.stringCount) << std::endl;
+		else
+			std::cout << std::format("  {}: {} unique strings, {} added, {} removed, {} changed sections", file.path, file.stringCount, file.addedCount, file.removedCount, file.changedSections) << std::endl;
 	}
-	return true;
 }
 
 int main(int argc, char* argv[])
 {
-	if (argc != 2)
+	const bool batch = argc >= 3 && argv[1] == BATCH_OPTION;
+
+	if (!batch && argc != 2 && !(argc == 4 && argv[2] == MERGE_OPTION))
 	{
-		std::cout << std::format("Usage: {} <path_to_exe>", argv[0]) << std::endl;
+		std::cout << std::format("Usage: {} <path_to_exe> [{} <path_to_tr.json>]", argv[0], MERGE_OPTION) << std::endl;
+		std::cout << std::format("       {} {} <path_to_exe> <path_to_exe> ...", argv[0], BATCH_OPTION) << std::endl;
 		return 1;
 	}
 
+	if (batch)
+	{
+		const std::vector<std::string> targets(argv + 2, argv + argc);
+
+		for (const std::string& target : targets)
+		{
+			if (!std::ifstream(target))
+			{
+				std::cerr << std::format("Error: Target file: \"{}\" not found", target) << std::endl;
+				return 1;
+			}
+		}
+
+		try
+		{
+			runBatch(targets);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error: " << e.what() << std::endl;
+			return 1;
+		}
+
+		return 0;
+	}
+
 	const std::string target = argv[1];
 
 	// Make sure the file exists
@@ -149,61 +190,67 @@ int main(int argc, char* argv[])
 
 	try
 	{
-		std::vector<char> data = getRData(target);
+		MappedFile file;
+		if (!file.open(target))
+			throw std::runtime_error(std::format("Failed to open file: {}", target));
 
-		std::vector<std::vector<char>> outputs;
-		std::vector<char> output;
+		std::cout << "Getting data sections ... " << std::flush;
+		const std::vector<DataSection> sections = getDataSections(file);
+		std::cout << "Done" << std::endl;
 
-		std::cout << "Extracting strings from section data ... " << std::flush;
+		if (sections.empty())
+			throw std::runtime_error("No initialized data sections found");
 
-		for (size_t i = 0; i < data.size(); i++)
-		{
-			if (data[i] == 0)
-			{
-				if (isValidSJisString(output) && !isPureAsciiString(output))
-					outputs.push_back(output);
+		for (const DataSection& section : sections)
+			std::cout << std::format("  {:<8} RVA 0x{:08X}, {} bytes", section.name, section.rva, section.data.size()) << std::endl;
 
-				output.clear();
-
-				// Skip all consecutive zero bytes
-				while (i + 1 < data.size() && data[i + 1] == 0)
-					i++;
+		if (argc == 4)
+		{
+			std::cout << "Merging translations ... " << std::flush;
+			const MergeResult result = mergeTranslations(sections, argv[3]);
+			std::cout << "Done" << std::endl;
 
-				continue;
-			}
+			if (result.upToDate)
+				std::cout << "Sections are unchanged since the last merge, skipped the extraction" << std::endl;
 
-			output.push_back(data[i]);
+			std::cout << std::format("Kept entries: {}, new entries: {}, vanished entries: {}", result.keptCount, result.addedCount, result.vanishedCount) << std::endl;
+			return 0;
 		}
 
+		std::cout << "Extracting strings from section data ... " << std::flush;
+		const std::vector<std::vector<StringRef>> sectionStrings = extractSections(sections);
 		std::cout << "Done" << std::endl;
-		std::cout << "Total strings extracted: " << outputs.size() << std::endl;
-		std::cout << "Creating JSON file ... " << std::flush;
 
-		nlohmann::ordered_json j;
+		size_t totalCount = 0;
+		for (const std::vector<StringRef>& strings : sectionStrings)
+			totalCount += strings.size();
 
-		for (const auto& segment : outputs)
-		{
-			std::string sjisStr(segment.begin(), segment.end());
-			std::string utf8Str = sjis2utf8(sjisStr.c_str());
-			if (!j.contains(utf8Str))
-				j[utf8Str] = "";
-		}
+		std::cout << "Total strings extracted: " << totalCount << std::endl;
 
-		std::ofstream jsonFile("output.json");
-		if (!jsonFile)
+		const std::vector<ExtractedString> strings = groupStrings(sections, sectionStrings);
+
+		std::cout << "Creating JSON files ... " << std::flush;
+
+		std::ofstream jsonFile(OUTPUT_FILE);
+		std::ofstream locationsFile(LOCATIONS_FILE);
+		if (!jsonFile || !locationsFile)
 		{
 			std::cerr << "Error creating JSON file." << std::endl;
 			return 1;
 		}
 
-		jsonFile << j.dump(4);
+		writeStrings(strings, jsonFile);
+		writeLocations(sections, strings, locationsFile);
 		jsonFile.close();
+		locationsFile.close();
 
 		std::cout << "Done" << std::endl;
+		std::cout << "Unique strings written: " << strings.size() << std::endl;
 	}
 	catch (const std::exception& e)
 	{
 		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
 	}
 
 	return 0;
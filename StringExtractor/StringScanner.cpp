@@ -0,0 +1,191 @@
+/*
+ *  File: StringScanner.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#include "StringScanner.hpp"
+
+#include "../EternalRedirect/Cp932.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define EXTRACTOR_SIMD 1
+#else
+#define EXTRACTOR_SIMD 0
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Characters encoded in a single byte that may appear in a string: printable ASCII, tab, newline, carriage return and half-width katakana
+static bool isSingleByteChar(const uint8_t byte)
+{
+	return (byte >= 0x20 && byte <= 0x7E) || (byte >= 0xA1 && byte <= 0xDF) || byte == '\n' || byte == '\t' || byte == '\r';
+}
+
+// Bytes classified at once, also the number of strings that can end within one block
+static const size_t BLOCK_SIZE = 16;
+
+#if EXTRACTOR_SIMD
+static uint32_t lowestSetBit(const uint32_t value)
+{
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanForward(&idx, value);
+	return static_cast<uint32_t>(idx);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+//
+// Classify a block of section bytes, bit i of zeros is set if byte i terminates a string,
+// of multiByte if byte i is neither a terminator nor a single byte character and of nonAscii if byte i is above 0x7F
+//
+static void classifyBlock(const uint8_t* pData, uint32_t& zeros, uint32_t& multiByte, uint32_t& nonAscii)
+{
+	const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData));
+
+	const auto inRange = [&bytes](const uint8_t first, const uint8_t last) {
+		const __m128i offset = _mm_sub_epi8(bytes, _mm_set1_epi8(static_cast<char>(first)));
+		return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(static_cast<char>(last - first))), offset);
+	};
+
+	const __m128i isZero = _mm_cmpeq_epi8(bytes, _mm_setzero_si128());
+
+	__m128i isSingle = _mm_or_si128(inRange(0x20, 0x7E), inRange(0xA1, 0xDF));
+	isSingle         = _mm_or_si128(isSingle, inRange('\t', '\n'));
+	isSingle         = _mm_or_si128(isSingle, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+
+	zeros     = static_cast<uint32_t>(_mm_movemask_epi8(isZero));
+	multiByte = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(isSingle, isZero))) & 0xFFFF;
+	nonAscii  = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+}
+#endif
+
+//
+// Runs are validated by a state machine that pairs each lead byte with its trail byte and rejects pairs without a mapping.
+// Blocks without lead bytes, which is most of the section, skip the state machine and are handled with bit masks.
+//
+std::vector<StringRef> extractStrings(const uint8_t* pData, const size_t size)
+{
+	std::vector<StringRef> strings(BLOCK_SIZE);
+	size_t count = 0;
+
+	// invalid and nonAscii are non zero if the current run contains such a byte, lead is the lead byte waiting for its trail byte
+	size_t start      = 0;
+	uint32_t invalid  = 0;
+	uint32_t nonAscii = 0;
+	uint8_t lead      = 0;
+
+	// Every run is written, but only kept by advancing count. Terminators are too frequent and random to branch on.
+	const auto finishString = [&](const size_t end) {
+		strings[count] = { static_cast<uint32_t>(start), static_cast<uint32_t>(end - start) };
+		count += (invalid == 0) & (nonAscii != 0);
+
+		start    = end + 1;
+		invalid  = 0;
+		nonAscii = 0;
+	};
+
+	// Makes room for the runs that can end within the next block
+	const auto reserveBlock = [&]() {
+		if (strings.size() - count < BLOCK_SIZE)
+			strings.resize(strings.size() * 2);
+	};
+
+	const auto scanByte = [&](const size_t pos) {
+		const uint8_t byte = pData[pos];
+
+		if (lead != 0)
+		{
+			invalid |= !cp932::isDoubleByteChar(lead, byte);
+			lead = 0;
+
+			// A zero instead of the trail byte still ends the run
+			if (byte != 0)
+				return;
+		}
+
+		if (byte == 0)
+			finishString(pos);
+		else if (isSingleByteChar(byte))
+			nonAscii |= byte > 0x7F;
+		else if (cp932::isLeadByte(byte))
+		{
+			lead     = byte;
+			nonAscii = 1;
+		}
+		else
+			invalid = 1;
+	};
+
+	size_t pos = 0;
+
+#if EXTRACTOR_SIMD
+	for (; pos + BLOCK_SIZE <= size; pos += BLOCK_SIZE)
+	{
+		uint32_t zeros;
+		uint32_t multiByte;
+		uint32_t nonAsciiBytes;
+		classifyBlock(pData + pos, zeros, multiByte, nonAsciiBytes);
+
+		reserveBlock();
+
+		if (multiByte != 0 || lead != 0)
+		{
+			for (size_t i = 0; i < BLOCK_SIZE; i++)
+				scanByte(pos + i);
+
+			continue;
+		}
+
+		while (zeros != 0)
+		{
+			const uint32_t idx    = lowestSetBit(zeros);
+			const uint32_t before = (1u << idx) - 1;
+
+			nonAscii |= nonAsciiBytes & before;
+			finishString(pos + idx);
+
+			// Only the bytes after the terminator belong to the next string
+			nonAsciiBytes &= ~before;
+			zeros &= zeros - 1;
+		}
+
+		nonAscii |= nonAsciiBytes;
+	}
+#endif
+
+	for (; pos < size; pos++)
+	{
+		if (pData[pos] == 0)
+			reserveBlock();
+
+		scanByte(pos);
+	}
+
+	strings.resize(count);
+	return strings;
+}
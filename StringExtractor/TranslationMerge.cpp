@@ -0,0 +1,324 @@
+/*
+ *  File: TranslationMerge.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "TranslationMerge.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+
+#include "../EternalRedirect/JsonReader.hpp"
+#include "../EternalRedirect/JsonWriter.hpp"
+#include "../EternalRedirect/MappedFile.hpp"
+#include "../EternalRedirect/TranslationLoader.hpp"
+#include "../EternalRedirect/TranslationTable.hpp"
+
+static const std::string VANISHED_FILE = "vanished.json";
+
+static const std::string INDEX_EXTENSION  = ".index";
+static const std::string BACKUP_EXTENSION = ".bak";
+static const std::string TEMP_EXTENSION   = ".tmp";
+
+// Merge index layout: header followed by the sorted hashes of all extracted strings
+static const uint32_t INDEX_MAGIC   = 0x58444953; // "SIDX"
+static const uint32_t INDEX_VERSION = 1;
+
+//
+// Entry of the translation file a merge runs on, the value is kept as the raw JSON text from the file
+//
+struct ExistingEntry
+{
+	std::string key;
+	size_t valueOffset = 0;
+	size_t valueLength = 0;
+};
+
+struct MergeIndexHeader
+{
+	uint32_t magic       = INDEX_MAGIC;
+	uint32_t version     = INDEX_VERSION;
+	uint64_t contentHash = 0;
+	uint64_t keyCount    = 0;
+};
+
+// Changes whenever the strings found in the sections could change
+static uint64_t hashSections(const std::vector<DataSection>& sections)
+{
+	std::vector<uint64_t> hashes;
+
+	for (const DataSection& section : sections)
+	{
+		hashes.push_back(hashBytes(section.name.data(), section.name.size()));
+		hashes.push_back(hashBytes(section.data.data(), section.data.size()));
+		hashes.push_back(section.rva);
+	}
+
+	return hashBytes(reinterpret_cast<const char*>(hashes.data()), hashes.size() * sizeof(uint64_t));
+}
+
+// Returns false if there is no index or it was created for different section contents
+static bool readMergeIndex(const std::string& path, const uint64_t contentHash, std::vector<uint64_t>& keyHashes)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	MergeIndexHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!file || header.magic != INDEX_MAGIC || header.version != INDEX_VERSION || header.contentHash != contentHash)
+		return false;
+
+	// A truncated or damaged index must not make the key count an allocation size
+	std::error_code error;
+	const uintmax_t fileSize = std::filesystem::file_size(path, error);
+
+	if (error || header.keyCount != (fileSize - sizeof(header)) / sizeof(uint64_t))
+		return false;
+
+	keyHashes.resize(header.keyCount);
+	file.read(reinterpret_cast<char*>(keyHashes.data()), static_cast<std::streamsize>(keyHashes.size() * sizeof(uint64_t)));
+
+	return static_cast<bool>(file);
+}
+
+static void writeMergeIndex(const std::string& path, const uint64_t contentHash, const std::vector<uint64_t>& keyHashes)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		throw std::runtime_error("Failed to create file: " + path);
+
+	MergeIndexHeader header;
+	header.contentHash = contentHash;
+	header.keyCount    = keyHashes.size();
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(keyHashes.data()), static_cast<std::streamsize>(keyHashes.size() * sizeof(uint64_t)));
+}
+
+//
+// Streams the keys of a translation file, the values are only skipped over and remembered by their position
+//
+static std::vector<ExistingEntry> readExistingEntries(const MappedFile& file)
+{
+	JsonReader reader(reinterpret_cast<const char*>(file.data()), file.size());
+	std::vector<ExistingEntry> entries;
+
+	reader.expect('{');
+
+	if (!reader.consume('}'))
+	{
+		do
+		{
+			ExistingEntry& entry = entries.emplace_back();
+			entry.key.assign(reader.readString());
+			reader.expect(':');
+
+			entry.valueOffset = reader.offset();
+			reader.skipValue();
+			entry.valueLength = reader.position() - entry.valueOffset;
+		} while (reader.consume(','));
+
+		reader.expect('}');
+	}
+
+	if (!reader.atEnd())
+		reader.fail("unexpected data after the translations");
+
+	return entries;
+}
+
+//
+// Existing entries keep their value and position, new strings are appended with an empty translation.
+// New entries use the same shape as the existing ones, plain strings or objects with text and pixel lengths.
+//
+static void writeMerged(const MappedFile& file, const std::vector<ExistingEntry>& entries, const std::vector<const ExtractedString*>& added, std::ostream& stream)
+{
+	const std::string_view data(reinterpret_cast<const char*>(file.data()), file.size());
+	JsonWriter writer(stream);
+	std::string normalized;
+
+	// The window title is a string in both shapes
+	const auto shapeIt = std::find_if(entries.begin(), entries.end(), [](const ExistingEntry& entry) { return entry.key != WINDOW_TITLE_KEY; });
+	const bool objects = shapeIt != entries.end() && data[shapeIt->valueOffset] == '{';
+
+	writer.beginObject();
+
+	for (const ExistingEntry& entry : entries)
+	{
+		const std::string_view value = data.substr(entry.valueOffset, entry.valueLength);
+		writer.key(entry.key);
+
+		// Files written in text mode on Windows use CRLF, the stream adds the CR again.
+		// Strings can not contain a raw CR, so every CR in the value is whitespace.
+		if (value.find('\r') == std::string_view::npos)
+			writer.raw(value);
+		else
+		{
+			normalized.assign(value);
+			normalized.erase(std::remove(normalized.begin(), normalized.end(), '\r'), normalized.end());
+			writer.raw(normalized);
+		}
+	}
+
+	for (const ExtractedString* pString : added)
+	{
+		writer.key(pString->text);
+
+		if (!objects)
+		{
+			writer.string("");
+			continue;
+		}
+
+		// Same value scripts/fix.py creates for an empty translation
+		writer.beginObject();
+		writer.key("text");
+		writer.string("");
+		writer.key("pixel_lengths");
+		writer.beginArray();
+		writer.number(0);
+		writer.endArray();
+		writer.endObject();
+	}
+
+	writer.endObject();
+}
+
+MergeResult mergeTranslations(const std::vector<DataSection>& sections, const std::string& path)
+{
+	const std::string indexPath = path + INDEX_EXTENSION;
+	const uint64_t contentHash  = hashSections(sections);
+
+	std::vector<uint64_t> keyHashes;
+	const bool hasIndex = readMergeIndex(indexPath, contentHash, keyHashes);
+
+	MappedFile file;
+	std::vector<ExistingEntry> entries;
+
+	if (std::filesystem::exists(path))
+	{
+		if (!file.open(path) && std::filesystem::file_size(path) != 0)
+			throw std::runtime_error("Failed to open file: " + path);
+
+		if (file.isOpen())
+			entries = readExistingEntries(file);
+	}
+
+	// The index only stores hashes, the extracted strings are compared with the keys byte by byte
+	std::unordered_set<uint64_t> existingHashes;
+	std::unordered_set<std::string_view> existingKeys;
+
+	for (const ExistingEntry& entry : entries)
+	{
+		existingHashes.insert(hashBytes(entry.key.data(), entry.key.size()));
+		existingKeys.insert(entry.key);
+	}
+
+	const bool upToDate = hasIndex && std::all_of(keyHashes.begin(), keyHashes.end(), [&](const uint64_t hash) { return existingHashes.count(hash) != 0; });
+
+	std::vector<ExtractedString> strings;
+	std::vector<const ExtractedString*> added;
+	std::unordered_set<std::string_view> extractedKeys;
+
+	if (!upToDate)
+	{
+		strings = groupStrings(sections, extractSections(sections));
+
+		keyHashes.clear();
+
+		for (const ExtractedString& string : strings)
+		{
+			const uint64_t hash = hashBytes(string.text.data(), string.text.size());
+			keyHashes.push_back(hash);
+			extractedKeys.insert(string.text);
+
+			if (existingKeys.count(string.text) == 0)
+				added.push_back(&string);
+		}
+
+		std::sort(keyHashes.begin(), keyHashes.end());
+	}
+
+	const std::string vanishedPath = (std::filesystem::path(path).parent_path() / VANISHED_FILE).string();
+
+	std::ofstream vanishedFile(vanishedPath);
+	if (!vanishedFile)
+		throw std::runtime_error("Failed to create file: " + vanishedPath);
+
+	MergeResult result;
+	result.upToDate   = upToDate;
+	result.keptCount  = entries.size();
+	result.addedCount = added.size();
+
+	{
+		JsonWriter writer(vanishedFile);
+		writer.beginArray();
+
+		for (const ExistingEntry& entry : entries)
+		{
+			if (entry.key == WINDOW_TITLE_KEY)
+				continue;
+
+			if (upToDate ? std::binary_search(keyHashes.begin(), keyHashes.end(), hashBytes(entry.key.data(), entry.key.size())) : extractedKeys.count(entry.key) != 0)
+				continue;
+
+			writer.string(entry.key);
+			result.vanishedCount++;
+		}
+
+		writer.endArray();
+	}
+
+	vanishedFile.close();
+
+	// The original is only replaced once the merged file is complete, the previous version is kept as backup
+	if (!added.empty())
+	{
+		const std::string tempPath = path + TEMP_EXTENSION;
+		std::ofstream mergedFile(tempPath);
+		if (!mergedFile)
+			throw std::runtime_error("Failed to create file: " + tempPath);
+
+		writeMerged(file, entries, added, mergedFile);
+		mergedFile.close();
+		file.close();
+
+		if (std::filesystem::exists(path))
+			std::filesystem::rename(path, path + BACKUP_EXTENSION);
+
+		std::filesystem::rename(tempPath, path);
+	}
+
+	if (!upToDate)
+		writeMergeIndex(indexPath, contentHash, keyHashes);
+
+	return result;
+}
@@ -0,0 +1,49 @@
+/*
+ *  File: TranslationMerge.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "SectionStrings.hpp"
+
+struct MergeResult
+{
+	bool upToDate        = false;
+	size_t keptCount     = 0;
+	size_t addedCount    = 0;
+	size_t vanishedCount = 0;
+};
+
+//
+// Merges the strings of the sections into an existing translation file.
+// Translations of strings that are still present are kept, new strings are added and strings that are gone
+// are listed in vanished.json next to the file. If the index shows the sections did not change since the
+// last merge and the file still contains every string, the extraction is skipped.
+// Throws std::runtime_error if a file can not be read or written.
+//
+MergeResult mergeTranslations(const std::vector<DataSection>& sections, const std::string& path);
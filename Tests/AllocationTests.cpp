@@ -0,0 +1,131 @@
+/*
+ *  File: AllocationTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "../EternalRedirect/Epoch.hpp"
+#include "../EternalRedirect/HookStats.hpp"
+#include "../EternalRedirect/TranslationHooks.hpp"
+#include "Test.hpp"
+
+// Every allocation of the test binary goes through these, the default array and nothrow forms forward to them
+static std::atomic<size_t> g_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* p = std::malloc(size != 0 ? size : 1))
+		return p;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+// Same frame as Mine_CopyFunc, returns whether the game would get a translation
+static bool copyHook(TranslationSnapshot* pSnapshot, ScratchBuffer& scratch, TranslationEntry& largest, const char* pStr)
+{
+	stats::HookScope scope(stats::Hook::CopyFunc);
+	epoch::ReadGuard guard;
+
+	size_t length = 0;
+	return copyTranslation(pSnapshot, pStr, scratch, scope, &largest, length) != nullptr;
+}
+
+// Same frame as Mine_DrawFormatVStringToHandle, returns whether the game would draw pExpected
+static bool drawHook(TranslationSnapshot* pSnapshot, TranslationEntry& largest, const char* pExpected, const char* pFormat, ...)
+{
+	stats::HookScope scope(stats::Hook::DrawFormatVStringToHandle);
+	epoch::ReadGuard guard;
+
+	char buffer[4096];
+	va_list args;
+	va_start(args, pFormat);
+
+	const char* pStr = drawString(pSnapshot, pFormat, args, buffer, sizeof(buffer), scope, largest);
+	va_end(args);
+
+	return strcmp(pStr, pExpected) == 0;
+}
+
+TEST_CASE(hookHitAndMissDoNotAllocate)
+{
+	TranslationTableBuilder builder;
+	builder.insert("\x83\x5E\x83\x43\x83\x67\x83\x8B", "Title", { 40 });
+	builder.insert("menu", "Menu\nwith two lines", { 32, 120 });
+	builder.insert("%d damage", "%d Schaden", { 60 });
+	builder.insert("HP 5", "Health 5", { 50 });
+
+	std::unique_ptr<TranslationSnapshot> pSnapshot = std::make_unique<TranslationSnapshot>();
+	CHECK(pSnapshot->table.load(builder.build()));
+
+	// Strings inside the cached section take the pointer cache path, the others are hashed on every call
+	static const char RDATA[] = "menu\0not translated";
+	pSnapshot->rdataCache.init(RDATA, sizeof(RDATA));
+
+	const std::string heapHit  = "\x83\x5E\x83\x43\x83\x67\x83\x8B";
+	const std::string heapMiss = "not translated either";
+
+	ScratchBuffer scratch;
+	TranslationEntry largest;
+
+	const auto runHooks = [&]() {
+		CHECK(copyHook(pSnapshot.get(), scratch, largest, RDATA));
+		CHECK(!copyHook(pSnapshot.get(), scratch, largest, RDATA + 5));
+		CHECK(copyHook(pSnapshot.get(), scratch, largest, heapHit.c_str()));
+		CHECK(!copyHook(pSnapshot.get(), scratch, largest, heapMiss.c_str()));
+
+		// Translated template, translated formatted string and a miss
+		CHECK(drawHook(pSnapshot.get(), largest, "12 Schaden", "%d damage", 12));
+		CHECK(drawHook(pSnapshot.get(), largest, "Health 5", "HP %d", 5));
+		CHECK(drawHook(pSnapshot.get(), largest, "MP 7", "MP %d", 7));
+	};
+
+	// The first calls register the thread records and size the scratch buffer
+	runHooks();
+
+	const size_t allocationsBefore = g_allocations.load();
+
+	for (uint32_t i = 0; i < 1000; i++)
+		runHooks();
+
+	CHECK(g_allocations.load() == allocationsBefore);
+}
@@ -0,0 +1,144 @@
+/*
+ *  File: BatchExtractionTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "../StringExtractor/BatchExtraction.hpp"
+#include "Test.hpp"
+
+static const std::filesystem::path BATCH_DIRECTORY = std::filesystem::temp_directory_path() / "EternalRedirectBatchTest";
+
+// Section data with the strings in Shift-JIS, each followed by a zero
+static std::string sectionData(const std::vector<std::string>& strings)
+{
+	std::string data;
+
+	for (const std::string& string : strings)
+	{
+		cp932::appendSjis(string, data);
+		data.push_back('\0');
+	}
+
+	return data;
+}
+
+static std::string readFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static BatchVersion batchVersion(const std::string& name, const std::vector<DataSection>& sections)
+{
+	BatchVersion version;
+	version.path     = name + ".exe";
+	version.name     = name;
+	version.sections = sections;
+
+	return version;
+}
+
+TEST_CASE(shareSectionsComparesBytes)
+{
+	const std::string first  = sectionData({ "abcd" });
+	const std::string second = sectionData({ "abce" });
+	const std::string copy   = first;
+
+	std::vector<BatchVersion> versions;
+	versions.push_back(batchVersion("1_a", { { ".data", 0x1000, first }, { ".rdata", 0x2000, second } }));
+	versions.push_back(batchVersion("2_b", { { ".rdata", 0x3000, second }, { ".data", 0x1000, copy }, { ".copy", 0x4000, copy }, { ".bss", 0x5000, {} } }));
+
+	const std::vector<DataSection> uniqueSections = shareSections(versions);
+	CHECK(uniqueSections.size() == 3);
+
+	// Equal bytes at other addresses and under other names share the id, the section of the id is the first one
+	CHECK(versions[0].sectionIds == std::vector<uint32_t>({ 0, 1 }));
+	CHECK(versions[1].sectionIds == std::vector<uint32_t>({ 1, 0, 0, 2 }));
+	CHECK(uniqueSections[0].rva == 0x1000);
+	CHECK(uniqueSections[1].name == ".rdata");
+	CHECK(uniqueSections[2].data.empty());
+}
+
+TEST_CASE(batchDiffsTrackSharedChangedAndDuplicatedSections)
+{
+	std::filesystem::remove_all(BATCH_DIRECTORY);
+	std::filesystem::create_directories(BATCH_DIRECTORY);
+
+	const std::string shared   = sectionData({ "共有", "こんにちは" });
+	const std::string before   = sectionData({ "変更前", "こんにちは", "変更前" });
+	const std::string after    = sectionData({ "変更後" });
+	const std::string restored = before;
+
+	// The shared section is duplicated in the first and the last version, the second one changes the other section
+	std::vector<BatchVersion> versions;
+	versions.push_back(batchVersion("1_v1", { { ".rdata", 0x1000, shared }, { ".data", 0x5000, before }, { ".copy", 0x9000, shared } }));
+	versions.push_back(batchVersion("2_v2", { { ".rdata", 0x2000, shared }, { ".data", 0x6000, after } }));
+	versions.push_back(batchVersion("3_v3", { { ".rdata", 0x1000, shared }, { ".data", 0x5000, restored }, { ".copy", 0x9000, shared } }));
+
+	const BatchResult result = extractBatch(versions, BATCH_DIRECTORY.string());
+	CHECK(result.sectionCount == 8);
+	CHECK(result.uniqueSectionCount == 3);
+	CHECK(result.files.size() == 3);
+
+	// The first version matches a single extraction, including the locations in the duplicated section
+	const std::vector<ExtractedString> strings = groupStrings(versions[0].sections, extractSections(versions[0].sections));
+
+	std::ostringstream json;
+	std::ostringstream locations;
+	writeStrings(strings, json);
+	writeLocations(versions[0].sections, strings, locations);
+
+	CHECK(readFile(BATCH_DIRECTORY / "1_v1.json") == json.str());
+	CHECK(readFile(BATCH_DIRECTORY / "1_v1_locations.json") == locations.str());
+	CHECK(result.files[0].stringCount == 3);
+
+	// こんにちは stays through the shared section, strings that are gone are no longer counted
+	const nlohmann::json secondDiff = nlohmann::json::parse(readFile(BATCH_DIRECTORY / "2_v2_diff.json"));
+	CHECK(secondDiff["base"] == "1_v1.exe");
+	CHECK(secondDiff["added"] == nlohmann::json::parse(R"(["変更後"])"));
+	CHECK(secondDiff["removed"] == nlohmann::json::parse(R"(["変更前"])"));
+	CHECK(result.files[1].stringCount == 3);
+	CHECK(result.files[1].changedSections == 3);
+
+	// Removing the duplicate again must not remove the strings of the shared section
+	const nlohmann::json thirdDiff = nlohmann::json::parse(readFile(BATCH_DIRECTORY / "3_v3_diff.json"));
+	CHECK(thirdDiff["base"] == "2_v2.exe");
+	CHECK(thirdDiff["added"] == nlohmann::json::parse(R"(["変更前"])"));
+	CHECK(thirdDiff["removed"] == nlohmann::json::parse(R"(["変更後"])"));
+	CHECK(result.files[2].stringCount == 3);
+	CHECK(result.files[2].addedCount == 1);
+	CHECK(result.files[2].removedCount == 1);
+	CHECK(result.files[2].changedSections == 3);
+
+	std::filesystem::remove_all(BATCH_DIRECTORY);
+}
@@ -0,0 +1,337 @@
+/*
+ *  File: Cp932Tests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "Test.hpp"
+
+static std::string toUtf8(const std::string& sjis)
+{
+	std::string utf8;
+	cp932::appendUtf8(sjis, utf8);
+	return utf8;
+}
+
+static std::string toSjis(const std::string& utf8)
+{
+	std::string sjis;
+	cp932::appendSjis(utf8, sjis);
+	return sjis;
+}
+
+static std::string encodeUtf8(const uint32_t codePoint)
+{
+	std::string utf8;
+
+	if (codePoint < 0x80)
+		utf8 += static_cast<char>(codePoint);
+	else if (codePoint < 0x800)
+	{
+		utf8 += static_cast<char>(0xC0 | (codePoint >> 6));
+		utf8 += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		utf8 += static_cast<char>(0xE0 | (codePoint >> 12));
+		utf8 += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		utf8 += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+
+	return utf8;
+}
+
+//
+// Every Shift-JIS character, single bytes and mapped double byte pairs
+//
+static std::vector<std::string> allSjisChars()
+{
+	std::vector<std::string> chars;
+
+	for (uint32_t c = 0; c <= 0xFF; c++)
+	{
+		if (!cp932::isLeadByte(static_cast<uint8_t>(c)))
+			chars.push_back(std::string(1, static_cast<char>(c)));
+	}
+
+	for (uint32_t lead = 0x81; lead <= 0xFC; lead++)
+	{
+		for (uint32_t trail = cp932::TRAIL_FIRST; trail <= cp932::TRAIL_LAST; trail++)
+		{
+			if (cp932::isDoubleByteChar(static_cast<uint8_t>(lead), static_cast<uint8_t>(trail)))
+				chars.push_back({ static_cast<char>(lead), static_cast<char>(trail) });
+		}
+	}
+
+	return chars;
+}
+
+TEST_CASE(everyMappedCodePointRoundTrips)
+{
+	uint32_t mapped = 0;
+
+	for (uint32_t codePoint = 0; codePoint <= 0xFFFF; codePoint++)
+	{
+		if (codePoint >= 0xD800 && codePoint < 0xE000)
+			continue;
+
+		const std::string utf8 = encodeUtf8(codePoint);
+		const std::string sjis = toSjis(utf8);
+
+		if (sjis == "?" && codePoint != '?')
+			continue;
+
+		mapped++;
+
+		// Encoded to the full width form like by Python's codec, e.g. U+00A2 becomes 0x8191, which is U+FFE0
+		if (codePoint == 0x00A2 || codePoint == 0x00A3 || codePoint == 0x00AC || codePoint == 0x2016 || codePoint == 0x2212 || codePoint == 0x301C)
+		{
+			CHECK(sjis.size() == 2);
+			continue;
+		}
+
+		CHECK(toUtf8(sjis) == utf8);
+	}
+
+	// Same count as Python's cp932 codec, which scripts/gen_cp932_tables.py builds the tables from
+	CHECK(mapped == 9408);
+}
+
+TEST_CASE(everySjisCharRoundTrips)
+{
+	uint32_t doubleByte = 0;
+	uint32_t duplicates = 0;
+
+	for (const std::string& sjis : allSjisChars())
+	{
+		const std::string utf8    = toUtf8(sjis);
+		const std::string encoded = toSjis(utf8);
+
+		// NEC and IBM extensions contain the same characters more than once, they encode to the form Windows picks
+		CHECK(toUtf8(encoded) == utf8);
+
+		if (sjis.size() == 2)
+			doubleByte++;
+		if (encoded != sjis)
+			duplicates++;
+	}
+
+	// Counted with Python's cp932 codec
+	CHECK(doubleByte == 9604);
+	CHECK(duplicates == 398);
+}
+
+//
+// WideCharToMultiByte prefers JIS X 0208, then NEC row 13, then the IBM extensions over the NEC selected copies.
+// Python's codec picks the NEC selected form for the IBM kanji.
+//
+TEST_CASE(duplicatesEncodeToTheWindowsForm)
+{
+	// 纊, 髙, ⅰ, ￤, ＇, Ⅰ, ㈱, ￢, ≒, ∵
+	const std::pair<const char*, const char*> forms[] = {
+		{ "\xE7\xBA\x8A", "\xFA\x5C" },
+		{ "\xE9\xAB\x99", "\xFB\xFC" },
+		{ "\xE2\x85\xB0", "\xFA\x40" },
+		{ "\xEF\xBF\xA4", "\xFA\x55" },
+		{ "\xEF\xBC\x87", "\xFA\x56" },
+		{ "\xE2\x85\xA0", "\x87\x54" },
+		{ "\xE3\x88\xB1", "\x87\x8A" },
+		{ "\xEF\xBF\xA2", "\x81\xCA" },
+		{ "\xE2\x89\x92", "\x81\xE0" },
+		{ "\xE2\x88\xB5", "\x81\xE6" },
+	};
+
+	for (const auto& [utf8, sjis] : forms)
+		CHECK(toSjis(utf8) == sjis);
+}
+
+#ifdef _WIN32
+//
+// Every character against the Win32 conversion the codec replaces.
+// Characters Windows only converts by best fit, e.g. U+00C0 to 'A', may become '?' instead.
+//
+TEST_CASE(codecMatchesWindowsConversion)
+{
+	for (const std::string& sjis : allSjisChars())
+	{
+		wchar_t wide[2] = {};
+		const int count = MultiByteToWideChar(932, 0, sjis.data(), static_cast<int>(sjis.size()), wide, 2);
+
+		CHECK(count == 1);
+		CHECK(toUtf8(sjis) == encodeUtf8(wide[0]));
+	}
+
+	for (uint32_t codePoint = 1; codePoint <= 0xFFFF; codePoint++)
+	{
+		if (codePoint >= 0xD800 && codePoint < 0xE000)
+			continue;
+
+		const wchar_t wide = static_cast<wchar_t>(codePoint);
+		char windows[2]    = {};
+		const int count    = WideCharToMultiByte(932, 0, &wide, 1, windows, sizeof(windows), nullptr, nullptr);
+
+		CHECK(count == 1 || count == 2);
+
+		wchar_t decoded      = 0;
+		const bool roundTrip = MultiByteToWideChar(932, 0, windows, count, &decoded, 1) == 1 && decoded == wide;
+
+		const std::string expected(windows, count);
+		const std::string actual = toSjis(encodeUtf8(codePoint));
+
+		CHECK(actual == expected || (!roundTrip && actual == "?"));
+	}
+}
+#endif
+
+//
+// Long strings take the SIMD paths, converting them at once must give the same result as converting every character alone
+//
+TEST_CASE(blockConversionMatchesCharacterConversion)
+{
+	const std::vector<std::string> chars = allSjisChars();
+	std::mt19937 random(932);
+
+	for (int round = 0; round < 500; round++)
+	{
+		std::string sjis;
+		std::string expectedUtf8;
+		std::string expectedSjis;
+
+		const size_t count = random() % 300;
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			// Mostly ASCII runs of varying length, so blocks start and end at every position
+			const std::string& c   = (random() % 4 != 0) ? chars[random() % 128] : chars[random() % chars.size()];
+			const std::string utf8 = toUtf8(c);
+
+			sjis += c;
+			expectedUtf8 += utf8;
+			expectedSjis += toSjis(utf8);
+		}
+
+		const std::string utf8 = toUtf8(sjis);
+		CHECK(utf8 == expectedUtf8);
+		CHECK(toSjis(utf8) == expectedSjis);
+	}
+}
+
+TEST_CASE(canonicalizeKeepsTheCharacter)
+{
+	uint32_t folded = 0;
+
+	for (const std::string& sjis : allSjisChars())
+	{
+		if (sjis.size() != 2)
+			continue;
+
+		std::string canonical = sjis;
+		cp932::canonicalize(canonical.data(), canonical.size());
+
+		// The same decode and encode the loader applies to the keys of tr.json
+		CHECK(canonical == toSjis(toUtf8(sjis)));
+		CHECK(cp932::findNonCanonical(canonical) == std::string_view::npos);
+
+		if (canonical != sjis)
+		{
+			CHECK(cp932::findNonCanonical(sjis) == 0);
+			folded++;
+		}
+	}
+
+	CHECK(folded == 398);
+}
+
+TEST_CASE(canonicalizeOnlyTouchesLeadBytes)
+{
+	// 0xED as the trail byte of 0x81 and a single byte character after ASCII must stay as they are.
+	// 纊 0xED40 becomes 0xFA5C, ≒ 0x8790 becomes 0x81E0.
+	std::string text = "a\x81\xED\xED\x40z\x87\x90";
+
+	CHECK(cp932::findNonCanonical(text) == 3);
+	cp932::canonicalize(text.data(), text.size());
+	CHECK(text == "a\x81\xED\xFA\x5Cz\x81\xE0");
+
+	std::string truncated = "ab\xED";
+	CHECK(cp932::findNonCanonical(truncated) == std::string_view::npos);
+}
+
+//
+// Throughput of both directions on 1 MiB of ASCII, of half-width katakana and of typical Japanese game text.
+// Build with -DETERNAL_AVX2=ON to measure the AVX2 paths instead of SSE2.
+//
+BENCHMARK(cp932Throughput)
+{
+#if defined(__AVX2__)
+	std::cout << "SIMD: AVX2" << std::endl;
+#elif defined(_M_X64) || defined(__SSE2__)
+	std::cout << "SIMD: SSE2" << std::endl;
+#else
+	std::cout << "SIMD: none" << std::endl;
+#endif
+
+	// "Hello world! ", "ｺﾝﾆﾁﾊ " and "「勇者は魔王を倒した。」HP 100"
+	const std::pair<const char*, std::string> texts[] = {
+		{ "ascii", "Hello world! " },
+		{ "kana", "\xBA\xDD\xC6\xC1\xCA " },
+		{ "japanese", "\x81\x75\x97\x45\x8E\xD2\x82\xCD\x96\x82\x89\xA4\x82\xF0\x93\x7C\x82\xB5\x82\xBD\x81\x42\x81\x76HP 100" },
+	};
+
+	for (const auto& [pName, pattern] : texts)
+	{
+		std::string sjis;
+		while (sjis.size() < (1 << 20))
+			sjis += pattern;
+
+		std::vector<char> utf8(cp932::maxUtf8Size(sjis.size()));
+		std::vector<char> back(cp932::maxSjisSize(utf8.size()));
+
+		const size_t iterations = 50;
+		size_t utf8Length       = 0;
+
+		double start = test::seconds();
+		for (size_t idx = 0; idx < iterations; idx++)
+			utf8Length = cp932::toUtf8(sjis.data(), sjis.size(), utf8.data());
+		test::report(std::string("toUtf8 ") + pName, test::seconds() - start, iterations, sjis.size() * iterations);
+
+		size_t sjisLength = 0;
+
+		start = test::seconds();
+		for (size_t idx = 0; idx < iterations; idx++)
+			sjisLength = cp932::toSjis(utf8.data(), utf8Length, back.data());
+		test::report(std::string("toSjis ") + pName, test::seconds() - start, iterations, utf8Length * iterations);
+
+		if (sjisLength != sjis.size())
+			std::cout << "Round trip changed the length of " << pName << std::endl;
+	}
+}
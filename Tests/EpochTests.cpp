@@ -0,0 +1,59 @@
+/*
+ *  File: EpochTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <thread>
+
+#include "../EternalRedirect/Epoch.hpp"
+#include "Test.hpp"
+
+static epoch::ThreadRecord* threadRecordOfNewThread()
+{
+	epoch::ThreadRecord* pRecord = nullptr;
+
+	std::thread([&] {
+		{
+			epoch::ReadGuard guard;
+			pRecord = &epoch::threadRecord();
+		}
+
+		epoch::unregisterThread();
+	}).join();
+
+	return pRecord;
+}
+
+TEST_CASE(exitedThreadsReuseTheirEpochRecord)
+{
+	epoch::ThreadRecord* pFirst = threadRecordOfNewThread();
+
+	for (int idx = 0; idx < 100; idx++)
+		CHECK(threadRecordOfNewThread() == pFirst);
+
+	CHECK(pFirst->epoch.load() == 0);
+
+	// A reused record must not hold up writers
+	epoch::synchronize();
+}
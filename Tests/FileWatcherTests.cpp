@@ -0,0 +1,63 @@
+/*
+ *  File: FileWatcherTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "../EternalRedirect/FileWatcher.hpp"
+#include "Test.hpp"
+
+TEST_CASE(stopWaitsForTheCallback)
+{
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "EternalRedirectWatcherTest";
+	std::filesystem::create_directories(directory);
+
+	std::atomic<bool> inCallback = false;
+	std::atomic<bool> finished   = false;
+
+	FileWatcher watcher;
+	CHECK(watcher.start(directory.string(), { "tr.json" }, [&](const std::string&) {
+		inCallback = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		finished = true;
+	}));
+
+	std::ofstream(directory / "tr.json") << "{}";
+
+	for (int idx = 0; idx < 500 && !inCallback; idx++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	CHECK(inCallback);
+
+	// The callback is still sleeping, stop has to wait until it returns
+	watcher.stop();
+	CHECK(finished);
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,102 @@
+/*
+ *  File: FontMetricsTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "../EternalRedirect/FontMetrics.hpp"
+#include "Test.hpp"
+
+//
+// Pixel lengths of scripts/fix.py for mplus-1c-medium.ttf at size 16, from get_pixel_length of every line
+//
+struct GoldenWidths
+{
+	const char* pText;
+	std::vector<uint32_t> widths;
+};
+
+static const GoldenWidths GOLDEN_WIDTHS[] = {
+	{ "", { 0 } },
+	{ " ", { 4 } },
+	{ "_", { 11 } },
+	{ "iiii", { 20 } },
+	{ "Hello, World!", { 97 } },
+	{ "The quick brown fox jumps over the lazy dog.", { 339 } },
+	// ひらがなとカタカナ, ｺﾝﾆﾁﾊ ｾｶｲ
+	{ "\xE3\x81\xB2\xE3\x82\x89\xE3\x81\x8C\xE3\x81\xAA\xE3\x81\xA8\xE3\x82\xAB\xE3\x82\xBF\xE3\x82\xAB\xE3\x83\x8A", { 144 } },
+	{ "\xEF\xBD\xBA\xEF\xBE\x9D\xEF\xBE\x86\xEF\xBE\x81\xEF\xBE\x8A \xEF\xBD\xBE\xEF\xBD\xB6\xEF\xBD\xB2", { 68 } },
+	// 勇者は魔王を倒した。, 「HP 100」を回復
+	{ "\xE5\x8B\x87\xE8\x80\x85\xE3\x81\xAF\xE9\xAD\x94\xE7\x8E\x8B\xE3\x82\x92\xE5\x80\x92\xE3\x81\x97\xE3\x81\x9F\xE3\x80\x82", { 160 } },
+	{ "\xE3\x80\x8CHP 100\xE3\x80\x8D\xE3\x82\x92\xE5\x9B\x9E\xE5\xBE\xA9", { 135 } },
+	// The font only has GPOS kerning, which PIL's basic layout does not apply
+	{ "AV To WA", { 74 } },
+	{ "AVAVAV", { 66 } },
+	// ᚠ, 😀 and ☃ are not in the font and use the missing glyph
+	{ "\xE1\x9A\xA0", { 6 } },
+	{ "\xF0\x9F\x98\x80", { 6 } },
+	{ "A\xE2\x98\x83" "B", { 27 } },
+	// Line one\nライン二
+	{ "Line one\n\xE3\x83\xA9\xE3\x82\xA4\xE3\x83\xB3\xE4\xBA\x8C", { 61, 64 } },
+};
+
+TEST_CASE(lineWidthsMatchFixPy)
+{
+	FontMetrics font;
+	CHECK(font.open(test::repoPath("scripts/mplus-1c-medium.ttf"), 16));
+
+	std::vector<uint32_t> widths;
+
+	for (const GoldenWidths& golden : GOLDEN_WIDTHS)
+	{
+		font.lineWidths(golden.pText, widths);
+		CHECK(widths == golden.widths);
+
+		if (golden.widths.size() == 1)
+			CHECK(font.lineWidth(golden.pText) == golden.widths[0]);
+	}
+}
+
+TEST_CASE(pairAdjustmentsOnlyApplyWhenEnabled)
+{
+	FontMetrics font;
+	CHECK(font.open(test::repoPath("scripts/mplus-1c-medium.ttf"), 16));
+
+	const uint32_t plain = font.lineWidth("AVAVAV");
+	CHECK(plain == 66);
+
+	font.setPairAdjustments(true);
+	CHECK(font.lineWidth("AVAVAV") < plain);
+	CHECK(font.lineWidth("iiii") == 20);
+}
+
+TEST_CASE(openRejectsMissingFonts)
+{
+	FontMetrics font;
+	CHECK(!font.open(test::repoPath("scripts/missing.ttf"), 16));
+	CHECK(!font.isOpen());
+	CHECK(!font.open(test::repoPath("scripts/mplus-1c-medium.ttf"), 0));
+}
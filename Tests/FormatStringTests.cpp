@@ -0,0 +1,80 @@
+/*
+ *  File: FormatStringTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <vector>
+
+#include "../EternalRedirect/FormatString.hpp"
+#include "Test.hpp"
+
+TEST_CASE(parseFormatArgsReadsTypesByPosition)
+{
+	std::vector<FormatArg> args;
+
+	CHECK(parseFormatArgs("%d damage to %s (%5.2f%%) %p %lld %*d", args));
+	CHECK((args == std::vector<FormatArg>{ FormatArg::Int, FormatArg::String, FormatArg::Double, FormatArg::Pointer, FormatArg::Int64, FormatArg::Int, FormatArg::Int }));
+
+	CHECK(parseFormatArgs("%2$s took %1$d, %1$d again", args));
+	CHECK((args == std::vector<FormatArg>{ FormatArg::Int, FormatArg::String }));
+
+	CHECK(parseFormatArgs("%ls %S %hs %I64u %zu %lu", args));
+	CHECK((args == std::vector<FormatArg>{ FormatArg::WideString, FormatArg::WideString, FormatArg::String, FormatArg::Int64, FormatArg::Int64, FormatArg::Int }));
+
+	CHECK(parseFormatArgs("no conversions 100%%", args));
+	CHECK(args.empty());
+}
+
+TEST_CASE(parseFormatArgsRejectsUnsafeFormats)
+{
+	std::vector<FormatArg> args;
+
+	CHECK(!parseFormatArgs("%d%n", args));
+	CHECK(!parseFormatArgs("%1$n", args));
+	CHECK(!parseFormatArgs("%1$d %s", args));
+	CHECK(!parseFormatArgs("%2$d", args));
+	CHECK(!parseFormatArgs("%1$d %1$s", args));
+	CHECK(!parseFormatArgs("100%", args));
+	CHECK(!parseFormatArgs("%q", args));
+	CHECK(!parseFormatArgs("%99$d", args));
+}
+
+TEST_CASE(isCompatibleFormatComparesArguments)
+{
+	CHECK(isCompatibleFormat("%d\x83\x5F\x83\x81\x81\x5B\x83\x57", "%d damage"));
+	CHECK(isCompatibleFormat("%s\x82\xAA%d", "%2$d from %1$s"));
+	CHECK(isCompatibleFormat("plain", "100%"));
+	CHECK(isCompatibleFormat("100%", "100%%"));
+	CHECK(isCompatibleFormat("%d%", "no conversions"));
+
+	CHECK(!isCompatibleFormat("%d", "%s"));
+	CHECK(!isCompatibleFormat("%d", "%d %d"));
+	CHECK(!isCompatibleFormat("%d %s", "%s %d"));
+	CHECK(!isCompatibleFormat("%d", "%d%n"));
+	CHECK(!isCompatibleFormat("%d", "%lld"));
+	CHECK(!isCompatibleFormat("%d", "%d%"));
+	CHECK(!isCompatibleFormat("%%", "%d"));
+	CHECK(!isCompatibleFormat("100%", "100%"));
+	CHECK(!isCompatibleFormat("%d%", "%s HP"));
+}
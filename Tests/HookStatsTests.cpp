@@ -0,0 +1,100 @@
+/*
+ *  File: HookStatsTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../EternalRedirect/HookStats.hpp"
+#include "Test.hpp"
+
+TEST_CASE(histogramBucketIsTheLog2OfTheTicks)
+{
+	CHECK(stats::histogramBucket(0) == 0);
+	CHECK(stats::histogramBucket(1) == 0);
+	CHECK(stats::histogramBucket(2) == 1);
+	CHECK(stats::histogramBucket(3) == 1);
+	CHECK(stats::histogramBucket(1024) == 10);
+	CHECK(stats::histogramBucket(UINT64_MAX) == stats::HISTOGRAM_BUCKETS - 1);
+}
+
+TEST_CASE(hookScopeCountsIntoTheThreadBlock)
+{
+	std::thread([] {
+		for (int idx = 0; idx < 10; idx++)
+		{
+			stats::HookScope scope(stats::Hook::GetDrawFormatStringWidth);
+
+			if (idx % 5 == 0)
+				scope.miss();
+			else
+				scope.hit(3);
+		}
+
+		const stats::HookCounters& counters = stats::threadStats().hooks[static_cast<uint32_t>(stats::Hook::GetDrawFormatStringWidth)];
+
+		CHECK(counters.calls == 10);
+		CHECK(counters.hits == 8);
+		CHECK(counters.misses == 2);
+		CHECK(counters.bytes == 24);
+
+		uint64_t histogramCalls = 0;
+		for (const std::atomic<uint64_t>& bucket : counters.histogram)
+			histogramCalls += bucket;
+
+		CHECK(histogramCalls == 10);
+	}).join();
+}
+
+TEST_CASE(reportSumsUpAllThreads)
+{
+	// SetWindowTitle is not recorded by any other test, so its totals are known
+	std::vector<std::thread> threads;
+
+	for (int thread = 0; thread < 4; thread++)
+	{
+		threads.emplace_back([] {
+			for (int idx = 0; idx < 100; idx++)
+			{
+				stats::HookScope scope(stats::Hook::SetWindowTitle);
+
+				if (idx < 25)
+					scope.hit(2);
+				else
+					scope.miss();
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	const std::string report = stats::report();
+
+	CHECK(report.find("Hook statistics (") == 0);
+	CHECK(report.find("SetWindowTitle: calls 400, hits 100, misses 300, bytes 200, mean ") != std::string::npos);
+	CHECK(report.find(" ns: ") != std::string::npos);
+}
@@ -0,0 +1,215 @@
+/*
+ *  File: SignatureCacheTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../EternalRedirect/SignatureCache.hpp"
+#include "../EternalRedirect/SignatureScanner.hpp"
+#include "Test.hpp"
+
+static const std::string CACHE_PATH = (std::filesystem::temp_directory_path() / "EternalRedirectSignatureCacheTest.cache").string();
+
+static void writeUInt32(std::vector<uint8_t>& data, const size_t offset, const uint32_t value)
+{
+	memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+// Start of a 64 bit executable file with 0x400 bytes of headers
+static std::vector<uint8_t> peHeader()
+{
+	std::vector<uint8_t> header(IMAGE_HEADER_READ_SIZE, 0xCC);
+	header[0] = 'M';
+	header[1] = 'Z';
+	writeUInt32(header, 0x3C, 0x80);
+
+	memcpy(header.data() + 0x80, "PE\0\0", 4);
+	writeUInt32(header, 0x80 + 8, 0x5F000000);
+	writeUInt32(header, 0x98 + 56, 0x00A00000);
+	writeUInt32(header, 0x98 + 60, 0x400);
+	writeUInt32(header, 0x98 + 64, 0x0012ABCD);
+
+	return header;
+}
+
+static ImageIdentity testIdentity()
+{
+	const std::vector<uint8_t> header = peHeader();
+	ImageIdentity identity;
+
+	CHECK(readImageIdentity(header.data(), header.size(), 0x00800000, identity));
+	return identity;
+}
+
+static void writeCache(const std::vector<uint8_t>& contents)
+{
+	std::ofstream(CACHE_PATH, std::ios::binary).write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+}
+
+static std::vector<uint8_t> readCache()
+{
+	std::ifstream file(CACHE_PATH, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST_CASE(readImageIdentityUsesTheFileHeaders)
+{
+	const std::vector<uint8_t> header = peHeader();
+	const ImageIdentity identity      = testIdentity();
+
+	CHECK(identity.isValid());
+	CHECK(identity.timeDateStamp == 0x5F000000);
+	CHECK(identity.sizeOfImage == 0x00A00000);
+	CHECK(identity.checkSum == 0x0012ABCD);
+	CHECK(identity.fileSize == 0x00800000);
+
+	// Only the headers are hashed, not the start of the first section behind them
+	std::vector<uint8_t> changed = header;
+	changed[0x400]               = 0;
+
+	ImageIdentity other;
+	CHECK(readImageIdentity(changed.data(), changed.size(), 0x00800000, other));
+	CHECK(other == identity);
+
+	// A different section table is a different build, even with the same time stamp and checksum
+	changed[0x200] = 0;
+	CHECK(readImageIdentity(changed.data(), changed.size(), 0x00800000, other));
+	CHECK(!(other == identity));
+
+	// Not a PE file, or headers cut off by the end of the file
+	std::vector<uint8_t> invalid = header;
+	invalid[0]                   = 'X';
+	CHECK(!readImageIdentity(invalid.data(), invalid.size(), 0x00800000, other));
+
+	invalid       = header;
+	invalid[0x81] = 'X';
+	CHECK(!readImageIdentity(invalid.data(), invalid.size(), 0x00800000, other));
+
+	invalid = header;
+	writeUInt32(invalid, 0x3C, 0xFFFFFFF0);
+	CHECK(!readImageIdentity(invalid.data(), invalid.size(), 0x00800000, other));
+
+	CHECK(!readImageIdentity(header.data(), 0xA0, 0x00800000, other));
+	CHECK(!readImageIdentity(header.data(), 0x20, 0x00800000, other));
+}
+
+TEST_CASE(signatureCacheRoundTrip)
+{
+	const ImageIdentity identity     = testIdentity();
+	const std::vector<uint32_t> rvas = { 0x1000, 0x23456, 0x7FFF0, 0x12, 0x9ABCD };
+	std::vector<uint32_t> loaded;
+
+	CHECK(saveSignatureCache(CACHE_PATH, identity, rvas));
+	CHECK(loadSignatureCache(CACHE_PATH, identity, loaded));
+	CHECK(loaded == rvas);
+
+	// Every part of the identity has to match
+	std::vector<ImageIdentity> others(5, identity);
+	others[0].timeDateStamp++;
+	others[1].sizeOfImage++;
+	others[2].checkSum++;
+	others[3].fileSize++;
+	others[4].headerHash++;
+
+	for (const ImageIdentity& other : others)
+		CHECK(!loadSignatureCache(CACHE_PATH, other, loaded));
+
+	// Without an identity nothing is cached or loaded
+	CHECK(!saveSignatureCache(CACHE_PATH, ImageIdentity(), rvas));
+	CHECK(!loadSignatureCache(CACHE_PATH, ImageIdentity(), loaded));
+
+	std::filesystem::remove(CACHE_PATH);
+}
+
+TEST_CASE(signatureCacheRejectsDamagedFiles)
+{
+	const ImageIdentity identity     = testIdentity();
+	const std::vector<uint32_t> rvas = { 0x1000, 0x2000, 0x3000 };
+	std::vector<uint32_t> loaded;
+
+	std::filesystem::remove(CACHE_PATH);
+	CHECK(!loadSignatureCache(CACHE_PATH, identity, loaded));
+
+	CHECK(saveSignatureCache(CACHE_PATH, identity, rvas));
+	const std::vector<uint8_t> valid = readCache();
+	CHECK(valid.size() == sizeof(sigcache::Header) + rvas.size() * sizeof(uint32_t));
+
+	// Cut off within the header and within the RVAs
+	for (const size_t size : { size_t(0), size_t(10), sizeof(sigcache::Header), valid.size() - 1 })
+	{
+		writeCache(std::vector<uint8_t>(valid.begin(), valid.begin() + static_cast<std::ptrdiff_t>(size)));
+		CHECK(!loadSignatureCache(CACHE_PATH, identity, loaded));
+	}
+
+	std::vector<uint8_t> damaged = valid;
+	damaged[0]                   = 'X';
+	writeCache(damaged);
+	CHECK(!loadSignatureCache(CACHE_PATH, identity, loaded));
+
+	// A cache of the previous version that keyed on the in-memory code
+	damaged = valid;
+	writeUInt32(damaged, offsetof(sigcache::Header, version), 1);
+	writeCache(damaged);
+	CHECK(!loadSignatureCache(CACHE_PATH, identity, loaded));
+
+	// An RVA count that is far too large must not be used as allocation size
+	damaged = valid;
+	writeUInt32(damaged, offsetof(sigcache::Header, rvaCount), 0xFFFFFFFF);
+	writeCache(damaged);
+	CHECK(!loadSignatureCache(CACHE_PATH, identity, loaded));
+
+	std::filesystem::remove(CACHE_PATH);
+}
+
+TEST_CASE(cachedRvasAreCheckedAgainstTheCode)
+{
+	std::vector<uint8_t> code(0x4000, 0x90);
+	const uint8_t function[] = { 0x48, 0x89, 0x5C, 0x24, 0x10, 0x57, 0x48, 0x83, 0xEC, 0x20 };
+	memcpy(code.data() + 0x1230, function, sizeof(function));
+
+	// A damaged or stale cache entry points somewhere else, the signature does not match there
+	const std::vector<uint32_t> rvas = { 0x1230, 0x2231, 0x5000 };
+
+	for (const uint32_t rva : rvas)
+	{
+		SignatureScanner scanner;
+		scanner.add("48 89 5C 24 ?? 57 48 83 EC 20");
+
+		CHECK(!scanner.accept(0, code.data(), code.size(), rva - 0x1000, 0x1000));
+		CHECK(!scanner.allFound());
+	}
+
+	SignatureScanner scanner;
+	scanner.add("48 89 5C 24 ?? 57 48 83 EC 20");
+
+	CHECK(scanner.accept(0, code.data(), code.size(), 0x1230, 0x1000));
+	CHECK(scanner.result(0) == 0x2230);
+}
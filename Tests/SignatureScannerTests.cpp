@@ -0,0 +1,313 @@
+/*
+ *  File: SignatureScannerTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../EternalRedirect/SignatureScanner.hpp"
+#include "Test.hpp"
+
+// Patterns of the hooked functions from EternalRedirect.cpp
+static const char* const GAME_SIGNATURES[] = {
+	"40 53 55 56 41 56 41 57 48 81",
+	"48 89 5C 24 10 57 48 83 EC 20 48 8B F9 48 C7 C3",
+	"48 89 4C 24 08 48 89 54 24 10 4C 89 44 24 18 4C 89 4C 24 20 53 56",
+	"48 89 5C 24 20 55 56 57 41 55 41 57 48 81 EC 40 04 00 00 48 8B 05 ?? ??",
+	"40 53 55 57 41 56 48 83 EC 28 48 BF FF FF FF FF",
+};
+
+static const uint32_t THREAD_COUNTS[] = { 1, 2, 4, 8 };
+
+// Code like bytes without any of the signatures, the scan has to look at the whole buffer
+static std::vector<uint8_t> syntheticImage(const size_t size)
+{
+	std::vector<uint8_t> image(size);
+	uint32_t state = 0x12345678;
+
+	for (uint8_t& byte : image)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		// Plenty of 0x40 and 0x48 bytes make the first byte prefilter pass often, like in real x64 code
+		byte = (state & 3) == 0 ? static_cast<uint8_t>(0x40 | (state >> 8 & 8)) : static_cast<uint8_t>(state >> 8);
+	}
+
+	return image;
+}
+
+// Copies the fixed bytes of the signature to offset, wildcards get random bytes so they are not all zero
+static void plantSignature(std::vector<uint8_t>& image, const Signature& signature, const size_t offset, std::mt19937& random)
+{
+	for (size_t idx = 0; idx < signature.length; idx++)
+		image[offset + idx] = signature.mask[idx] != 0 ? signature.bytes[idx] : static_cast<uint8_t>(random());
+}
+
+// Byte by byte search for the first match, the scanner has to agree with it
+static size_t referenceFind(const std::vector<uint8_t>& image, const Signature& signature)
+{
+	for (size_t pos = 0; pos + signature.length <= image.size(); pos++)
+	{
+		size_t idx = 0;
+		while (idx < signature.length && (image[pos + idx] & signature.mask[idx]) == signature.bytes[idx])
+			idx++;
+
+		if (idx == signature.length)
+			return pos;
+	}
+
+	return SignatureScanner::NOT_FOUND;
+}
+
+static SignatureScanner gameScanner()
+{
+	SignatureScanner scanner;
+
+	for (const char* pPattern : GAME_SIGNATURES)
+		scanner.add(pPattern);
+
+	return scanner;
+}
+
+TEST_CASE(scanParallelFindsTheSameOffsetsAsScan)
+{
+	std::vector<uint8_t> image = syntheticImage(1 << 20);
+	std::mt19937 random(42);
+
+	// Each signature twice, only the first match counts. One match straddles a likely chunk boundary.
+	const size_t offsets[] = { 100, 300000, 524280, 700000, 1048000 };
+	for (size_t idx = 0; idx < std::size(GAME_SIGNATURES); idx++)
+	{
+		Signature signature;
+		CHECK(signature.parse(GAME_SIGNATURES[idx]));
+
+		for (const size_t offset : { offsets[idx], offsets[(idx + 2) % std::size(offsets)] + 64 })
+			plantSignature(image, signature, offset, random);
+	}
+
+	SignatureScanner expected = gameScanner();
+	expected.scan(image.data(), image.size(), 0x1000);
+	CHECK(expected.allFound());
+
+	for (const uint32_t threadCount : THREAD_COUNTS)
+	{
+		SignatureScanner scanner = gameScanner();
+		scanner.scanParallel(image.data(), image.size(), 0x1000, threadCount);
+
+		for (uint32_t id = 0; id < scanner.size(); id++)
+			CHECK(scanner.result(id) == expected.result(id));
+	}
+}
+
+TEST_CASE(signatureParseRejectsInvalidPatterns)
+{
+	Signature signature;
+
+	CHECK(signature.parse("48 8b ?? ? 05"));
+	CHECK(signature.length == 5);
+	CHECK(signature.bytes.size() == 32);
+	CHECK(signature.bytes[1] == 0x8B);
+	CHECK(signature.mask[2] == 0x00 && signature.mask[3] == 0x00);
+
+	CHECK(signature.parse("  ?? 48  ?? 8B ?? "));
+	CHECK(signature.length == 5);
+	CHECK(signature.firstFixed == 1);
+	CHECK(signature.lastFixed == 3);
+
+	const char* const invalid[] = { "", "   ", "?? ??", "4", "48 8", "48 8B0", "488B", "48 GG", "48 ???", "48,8B", "0x48" };
+
+	for (const char* pPattern : invalid)
+	{
+		CHECK(!signature.parse(pPattern));
+		CHECK(!signature.isValid());
+		CHECK(signature.bytes.empty());
+	}
+
+	// Invalid patterns are never found
+	SignatureScanner scanner;
+	const uint32_t id = scanner.add("48 GG");
+	const std::vector<uint8_t> image(64, 0x48);
+
+	scanner.scan(image.data(), image.size());
+	CHECK(scanner.result(id) == SignatureScanner::NOT_FOUND);
+}
+
+TEST_CASE(scanFindsLeadingWildcards)
+{
+	std::vector<uint8_t> image = syntheticImage(4096);
+	std::mt19937 random(7);
+
+	// The prefilter compares the first fixed byte, not the first byte
+	Signature signature;
+	CHECK(signature.parse("?? ?? ?? 4C 8D 05 ?? ?? ?? ?? E8"));
+	CHECK(signature.firstFixed == 3);
+
+	for (const size_t offset : { size_t(0), size_t(1000), image.size() - signature.length })
+	{
+		std::vector<uint8_t> planted = image;
+		plantSignature(planted, signature, offset, random);
+
+		SignatureScanner scanner;
+		scanner.add("?? ?? ?? 4C 8D 05 ?? ?? ?? ?? E8");
+		scanner.scan(planted.data(), planted.size(), 0x1000);
+
+		CHECK(scanner.result(0) == referenceFind(planted, signature) + 0x1000);
+		CHECK(scanner.result(0) <= offset + 0x1000);
+	}
+}
+
+TEST_CASE(scanFindsLongSignaturesAtTheEnd)
+{
+	const char* const pPattern = "48 89 5C 24 ?? 55 56 57 41 54 41 55 41 56 41 57 48 8D AC 24 ?? ?? ?? ?? 48 81 EC ?? ?? ?? ?? 48 8B 05 ?? ?? ?? ?? 48 33 C4";
+
+	Signature signature;
+	CHECK(signature.parse(pPattern));
+	CHECK(signature.length > 32);
+
+	std::mt19937 random(11);
+
+	// Sizes that end inside and after a 16 byte block and one split into chunks, the signature ends the buffer
+	for (const size_t size : { size_t(4096), size_t(4097), size_t(4111), size_t(64) + signature.length, size_t(3 << 20) + 5 })
+	{
+		std::vector<uint8_t> image = syntheticImage(size);
+		plantSignature(image, signature, size - signature.length, random);
+
+		for (const uint32_t threadCount : { 1u, 4u })
+		{
+			SignatureScanner scanner;
+			scanner.add(pPattern);
+			scanner.scanParallel(image.data(), image.size(), 0, threadCount);
+
+			CHECK(scanner.result(0) == size - signature.length);
+		}
+
+		// One byte short of the signature
+		SignatureScanner scanner;
+		scanner.add(pPattern);
+		scanner.scan(image.data(), image.size() - 1);
+
+		CHECK(scanner.result(0) == SignatureScanner::NOT_FOUND);
+	}
+}
+
+TEST_CASE(scanMatchesReferenceWithAvx2AndSse2)
+{
+	std::mt19937 random(1234);
+	std::vector<uint8_t> image = syntheticImage(1 << 16);
+
+	// Random signatures of 1 to 80 bytes, most of them planted with random wildcard bytes, some near the end
+	std::vector<std::string> patterns;
+	std::vector<Signature> signatures;
+
+	while (signatures.size() < 200)
+	{
+		const size_t length = 1 + random() % 80;
+		std::string pattern;
+
+		for (size_t idx = 0; idx < length; idx++)
+		{
+			static const char HEX[] = "0123456789ABCDEF";
+			const uint8_t byte      = idx % 7 == 0 ? 0x48 : static_cast<uint8_t>(random());
+
+			pattern += random() % 4 == 0 ? std::string("??") : std::string({ HEX[byte >> 4], HEX[byte & 15] });
+			pattern += ' ';
+		}
+
+		Signature signature;
+		if (!signature.parse(pattern))
+			continue;
+
+		if (random() % 4 != 0)
+		{
+			const size_t offset = signatures.size() % 8 == 0 ? image.size() - length - random() % 8 : random() % (image.size() - length);
+			plantSignature(image, signature, offset, random);
+		}
+
+		patterns.push_back(pattern);
+		signatures.push_back(signature);
+	}
+
+	SignatureScanner sse2;
+	SignatureScanner avx2;
+
+	for (const std::string& pattern : patterns)
+	{
+		sse2.add(pattern);
+		avx2.add(pattern);
+	}
+
+	CHECK(!sse2.allowAvx2(false));
+
+	if (!avx2.allowAvx2(true))
+		std::cout << "AVX2 is not supported, only SSE2 is compared with the reference" << std::endl;
+
+	sse2.scan(image.data(), image.size());
+	avx2.scan(image.data(), image.size());
+
+	for (uint32_t id = 0; id < signatures.size(); id++)
+	{
+		const size_t expected = referenceFind(image, signatures[id]);
+
+		CHECK(sse2.result(id) == expected);
+		CHECK(avx2.result(id) == expected);
+	}
+}
+
+//
+// Scans a dump of the game's code section given as argument, or a synthetic 64 MiB image, with 1, 2, 4 and 8 threads
+//
+BENCHMARK(scanParallelThreads)
+{
+	std::vector<uint8_t> image;
+
+	if (!args.empty())
+	{
+		std::ifstream file(args[0], std::ios::binary);
+		image.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	if (image.empty())
+		image = syntheticImage(64 << 20);
+
+	for (const uint32_t threadCount : THREAD_COUNTS)
+	{
+		const size_t iterations = 5;
+		const double start      = test::seconds();
+
+		for (size_t idx = 0; idx < iterations; idx++)
+		{
+			SignatureScanner scanner = gameScanner();
+			scanner.scanParallel(image.data(), image.size(), 0, threadCount);
+		}
+
+		test::report("scanParallel " + std::to_string(threadCount) + " threads", test::seconds() - start, iterations, image.size() * iterations);
+	}
+}
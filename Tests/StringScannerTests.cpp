@@ -0,0 +1,168 @@
+/*
+ *  File: StringScannerTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <random>
+#include <vector>
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "../StringExtractor/StringScanner.hpp"
+#include "Test.hpp"
+
+//
+// Straightforward version of extractStrings: split at zeros, then decode every run character by character
+//
+static std::vector<StringRef> referenceStrings(const std::vector<uint8_t>& data)
+{
+	std::vector<StringRef> strings;
+	size_t start = 0;
+
+	for (size_t end = 0; end < data.size(); end++)
+	{
+		if (data[end] != 0)
+			continue;
+
+		bool valid    = true;
+		bool nonAscii = false;
+
+		for (size_t pos = start; pos < end && valid; pos++)
+		{
+			const uint8_t byte = data[pos];
+
+			if ((byte >= 0x20 && byte <= 0x7E) || byte == '\t' || byte == '\n' || byte == '\r')
+				continue;
+
+			nonAscii = true;
+
+			if (byte >= 0xA1 && byte <= 0xDF)
+				continue;
+
+			// The trail byte has to be part of the run, a lead byte right before the terminator is invalid
+			valid = pos + 1 < end && cp932::isDoubleByteChar(byte, data[pos + 1]);
+			pos++;
+		}
+
+		if (valid && nonAscii)
+			strings.push_back({ static_cast<uint32_t>(start), static_cast<uint32_t>(end - start) });
+
+		start = end + 1;
+	}
+
+	return strings;
+}
+
+//
+// Section like bytes: mostly text runs of ASCII, kana and mapped pairs, with some random bytes that break them
+//
+static std::vector<uint8_t> randomSection(std::mt19937& random)
+{
+	std::vector<uint8_t> data;
+	const size_t length = random() % 700;
+
+	while (data.size() < length)
+	{
+		switch (random() % 8)
+		{
+		case 0:
+			data.push_back(0);
+			break;
+		case 1:
+			data.push_back(static_cast<uint8_t>(random()));
+			break;
+		case 2:
+			data.push_back(static_cast<uint8_t>(0xA1 + random() % 0x3F));
+			break;
+		case 3:
+		case 4:
+		{
+			uint8_t lead;
+			uint8_t trail;
+
+			do
+			{
+				lead  = static_cast<uint8_t>(0x81 + random() % 0x7C);
+				trail = static_cast<uint8_t>(0x40 + random() % 0xBD);
+			} while (!cp932::isDoubleByteChar(lead, trail));
+
+			data.push_back(lead);
+			data.push_back(trail);
+			break;
+		}
+		default:
+			for (uint32_t count = random() % 40; count > 0; count--)
+				data.push_back(static_cast<uint8_t>(0x20 + random() % 0x5F));
+			break;
+		}
+	}
+
+	// The buffer ends exactly at the last byte, so the sanitizers catch reads past the section
+	data.resize(length);
+	data.shrink_to_fit();
+	return data;
+}
+
+static bool sameStrings(const std::vector<StringRef>& lhs, const std::vector<StringRef>& rhs)
+{
+	if (lhs.size() != rhs.size())
+		return false;
+
+	for (size_t idx = 0; idx < lhs.size(); idx++)
+	{
+		if (lhs[idx].offset != rhs[idx].offset || lhs[idx].length != rhs[idx].length)
+			return false;
+	}
+
+	return true;
+}
+
+TEST_CASE(extractStringsMatchesReferenceOnRandomSections)
+{
+	std::mt19937 random(22);
+	size_t found = 0;
+
+	for (int round = 0; round < 20000; round++)
+	{
+		const std::vector<uint8_t> data     = randomSection(random);
+		const std::vector<StringRef> actual = extractStrings(data.data(), data.size());
+
+		CHECK(sameStrings(actual, referenceStrings(data)));
+		found += actual.size();
+	}
+
+	// Make sure the generator produces enough valid strings to compare
+	CHECK(found > 20000);
+}
+
+TEST_CASE(extractStringsHandlesEdgeCases)
+{
+	// "あ" followed by a lead byte that has no trail before the terminator, then "ｱ" and an unterminated "い"
+	const std::vector<uint8_t> data      = { 0x82, 0xA0, 0x00, 0x41, 0x82, 0x00, 0xB1, 0x00, 0x82, 0xA2 };
+	const std::vector<StringRef> strings = extractStrings(data.data(), data.size());
+
+	CHECK(strings.size() == 2);
+	CHECK(sameStrings(strings, { { 0, 2 }, { 6, 1 } }));
+
+	CHECK(extractStrings(data.data(), 0).empty());
+}
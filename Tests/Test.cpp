@@ -0,0 +1,203 @@
+/*
+ *  File: Test.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "Test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace test
+{
+struct TestCase
+{
+	const char* pName = nullptr;
+	TestFunc func     = nullptr;
+};
+
+struct Benchmark
+{
+	const char* pName = nullptr;
+	BenchFunc func    = nullptr;
+};
+
+// Function local, registration runs during static initialization of the other files
+static std::vector<TestCase>& testCases()
+{
+	static std::vector<TestCase> cases;
+	return cases;
+}
+
+static std::vector<Benchmark>& benchmarks()
+{
+	static std::vector<Benchmark> benches;
+	return benches;
+}
+
+static uint32_t g_failures = 0;
+
+Registrar::Registrar(const char* pName, TestFunc func)
+{
+	testCases().push_back({ pName, func });
+}
+
+Registrar::Registrar(const char* pName, BenchFunc func)
+{
+	benchmarks().push_back({ pName, func });
+}
+
+void fail(const char* pFile, const int line, const char* pExpression)
+{
+	std::cerr << pFile << "(" << line << "): CHECK(" << pExpression << ") failed" << std::endl;
+	g_failures++;
+}
+
+double seconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void report(const std::string& name, const double elapsed, const size_t iterations, const size_t bytes)
+{
+	std::cout << name << ": " << elapsed * 1e9 / static_cast<double>(iterations) << " ns/iteration";
+
+	if (bytes != 0)
+		std::cout << ", " << static_cast<double>(bytes) / elapsed / (1024.0 * 1024.0) << " MiB/s";
+
+	std::cout << std::endl;
+}
+
+size_t peakMemory()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+#elif defined(__linux__)
+	std::ifstream status("/proc/self/status");
+	std::string line;
+
+	while (std::getline(status, line))
+	{
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return std::stoull(line.substr(6)) * 1024;
+	}
+#endif
+
+	return 0;
+}
+
+void resetPeakMemory()
+{
+#ifdef __linux__
+	std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+std::string repoPath(const std::string& relative)
+{
+	// Both builds compile this file by its absolute path, the repository is the parent of its directory
+	return (std::filesystem::path(__FILE__).parent_path().parent_path() / relative).string();
+}
+} // namespace test
+
+//
+// Without arguments all tests run, a test name runs only that test.
+// --bench runs all benchmarks, --bench <name> [args...] only the named one with its arguments.
+//
+int main(int argc, char* argv[])
+{
+	if (argc >= 2 && strcmp(argv[1], "--bench") == 0)
+	{
+		const std::vector<std::string> args(argv + (std::min)(argc, 3), argv + argc);
+		bool found = false;
+
+		for (const test::Benchmark& bench : test::benchmarks())
+		{
+			if (argc >= 3 && strcmp(argv[2], bench.pName) != 0)
+				continue;
+
+			std::cout << "[ BENCH ] " << bench.pName << std::endl;
+			bench.func(args);
+			found = true;
+		}
+
+		if (!found)
+		{
+			std::cerr << "Unknown benchmark: " << (argc >= 3 ? argv[2] : "") << std::endl;
+			return 1;
+		}
+
+		return 0;
+	}
+
+	uint32_t failedTests = 0;
+	uint32_t ranTests    = 0;
+
+	for (const test::TestCase& testCase : test::testCases())
+	{
+		if (argc >= 2 && strcmp(argv[1], testCase.pName) != 0)
+			continue;
+
+		const uint32_t failuresBefore = test::g_failures;
+
+		try
+		{
+			testCase.func();
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Unexpected exception: " << e.what() << std::endl;
+			test::g_failures++;
+		}
+
+		const bool passed = test::g_failures == failuresBefore;
+		std::cout << (passed ? "[  OK  ] " : "[ FAIL ] ") << testCase.pName << std::endl;
+
+		ranTests++;
+		if (!passed)
+			failedTests++;
+	}
+
+	if (ranTests == 0)
+	{
+		std::cerr << "No tests matched" << std::endl;
+		return 1;
+	}
+
+	std::cout << ranTests - failedTests << " of " << ranTests << " tests passed" << std::endl;
+	return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+/*
+ *  File: Test.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+//
+// Minimal test and benchmark runner, shared by the Windows and the portable build.
+// Tests and benchmarks register themselves, Test.cpp holds main.
+//
+namespace test
+{
+using TestFunc  = void (*)();
+using BenchFunc = void (*)(const std::vector<std::string>& args);
+
+struct Registrar
+{
+	Registrar(const char* pName, TestFunc func);
+	Registrar(const char* pName, BenchFunc func);
+};
+
+// Records a failed check, the test keeps running so every failure is reported
+void fail(const char* pFile, const int line, const char* pExpression);
+
+// Monotonic time in seconds, for benchmarks
+double seconds();
+
+// Prints a benchmark result line, throughput is skipped if bytes is 0
+void report(const std::string& name, const double elapsed, const size_t iterations, const size_t bytes = 0);
+
+// Peak resident memory of the process in bytes, 0 if the platform does not report it
+size_t peakMemory();
+
+// Lowers the peak to the current resident memory so the next phase can be measured on its own.
+// Only Linux supports this, elsewhere the peak keeps covering everything since the process started.
+void resetPeakMemory();
+
+// Absolute path of a file in the repository, e.g. "scripts/mplus-1c-medium.ttf"
+std::string repoPath(const std::string& relative);
+} // namespace test
+
+#define TEST_CASE(name)                                                                     \
+	static void name();                                                                     \
+	static const test::Registrar name##Registrar(#name, static_cast<test::TestFunc>(name)); \
+	static void name()
+
+#define BENCHMARK(name)                                                                      \
+	static void name(const std::vector<std::string>& args);                                  \
+	static const test::Registrar name##Registrar(#name, static_cast<test::BenchFunc>(name)); \
+	static void name([[maybe_unused]] const std::vector<std::string>& args)
+
+#define CHECK(expr)                                \
+	do                                             \
+	{                                              \
+		if (!(expr))                               \
+			test::fail(__FILE__, __LINE__, #expr); \
+	} while (0)
@@ -0,0 +1,59 @@
+/*
+ *  File: TranslationFixerTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "../EternalRedirect/FontMetrics.hpp"
+#include "../EternalRedirect/TranslationLoader.hpp"
+#include "../TrFixer/TranslationFixer.hpp"
+#include "Test.hpp"
+
+//
+// Tests/Data/tr.json was written by scripts/fix.py from Tests/Data/tr_org.json. The fixture covers repeated keys,
+// box length fixes with ties, escapes, control characters, empty and multi-line translations.
+//
+TEST_CASE(trFixerMatchesFixPy)
+{
+	FontMetrics font;
+	CHECK(font.open(test::repoPath("scripts/mplus-1c-medium.ttf"), FONT_SIZE));
+
+	Translations translations = loadTranslations(test::repoPath("Tests/Data/tr_org.json"));
+	CHECK(fixBoxLengths(translations, font) == 5);
+	measureTranslations(translations, font);
+
+	std::ostringstream output;
+	writeJson(translations, output);
+
+	// Text mode, so a checkout with CRLF line ends compares equal as well
+	std::ifstream expectedFile(test::repoPath("Tests/Data/tr.json"));
+	const std::string expected((std::istreambuf_iterator<char>(expectedFile)), std::istreambuf_iterator<char>());
+
+	CHECK(!expected.empty());
+	CHECK(output.str() == expected);
+}
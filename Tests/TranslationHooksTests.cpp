@@ -0,0 +1,139 @@
+/*
+ *  File: TranslationHooksTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <cstdarg>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "../EternalRedirect/Epoch.hpp"
+#include "../EternalRedirect/TranslationHooks.hpp"
+#include "Test.hpp"
+
+static std::unique_ptr<TranslationSnapshot> hookSnapshot()
+{
+	TranslationTableBuilder builder;
+	builder.insert("menu", "Menu\nwith two lines", { 32, 120 });
+	builder.insert("short", "S", { 10 });
+	builder.insert("plain", "Plain", { 40 });
+	builder.insert("%d damage", "%d Schaden", { 60 });
+	builder.insert("%d hit", "%d Treffer gelandet", { 90 });
+	builder.insert("%s and %s", "%s und %s", { 70 });
+	builder.insert("HP 5", "Health 5", { 50 });
+
+	std::unique_ptr<TranslationSnapshot> pSnapshot = std::make_unique<TranslationSnapshot>();
+	CHECK(pSnapshot->table.load(builder.build()));
+
+	return pSnapshot;
+}
+
+// Same frame as Mine_DrawFormatVStringToHandle, returns the string the game would draw
+static const char* drawHook(TranslationSnapshot* pSnapshot, TranslationEntry& largest, char* pBuffer, const size_t bufferSize, const char* pFormat, ...)
+{
+	stats::HookScope scope(stats::Hook::DrawFormatVStringToHandle);
+	epoch::ReadGuard guard;
+
+	va_list args;
+	va_start(args, pFormat);
+
+	const char* pStr = drawString(pSnapshot, pFormat, args, pBuffer, bufferSize, scope, largest);
+	va_end(args);
+
+	return pStr;
+}
+
+TEST_CASE(drawStringFormatsTranslatedTemplates)
+{
+	std::unique_ptr<TranslationSnapshot> pSnapshot = hookSnapshot();
+	TranslationEntry largest;
+	char buffer[64];
+
+	CHECK(std::string(drawHook(pSnapshot.get(), largest, buffer, sizeof(buffer), "%d damage", 12)) == "12 Schaden");
+	CHECK(std::string(drawHook(pSnapshot.get(), largest, buffer, sizeof(buffer), "%s and %s", "A", "B")) == "A und B");
+
+	// The formatted original is looked up if the template is not translated
+	CHECK(std::string(drawHook(pSnapshot.get(), largest, buffer, sizeof(buffer), "HP %d", 5)) == "Health 5");
+	CHECK(std::string(drawHook(pSnapshot.get(), largest, buffer, sizeof(buffer), "MP %d", 7)) == "MP 7");
+
+	// A translated template that does not fit falls back to the original, formatted with the same arguments
+	CHECK(std::string(drawHook(pSnapshot.get(), largest, buffer, 16, "%d hit", 42)) == "42 hit");
+
+	// Without translations every format string is still formatted
+	CHECK(std::string(drawHook(nullptr, largest, buffer, sizeof(buffer), "%d damage", 3)) == "3 damage");
+}
+
+TEST_CASE(drawStringPassesPlainStringsThrough)
+{
+	std::unique_ptr<TranslationSnapshot> pSnapshot = hookSnapshot();
+	TranslationEntry largest;
+	char buffer[64];
+
+	// Strings without conversions are never formatted, the game gets the table text or its own string
+	const char* const pUnknown = "unknown";
+
+	CHECK(drawHook(pSnapshot.get(), largest, buffer, sizeof(buffer), "plain") == pSnapshot->table.text(pSnapshot->table.find("plain")).data());
+	CHECK(drawHook(pSnapshot.get(), largest, buffer, sizeof(buffer), pUnknown) == pUnknown);
+	CHECK(drawHook(nullptr, largest, buffer, sizeof(buffer), pUnknown) == pUnknown);
+}
+
+TEST_CASE(widthStringMeasuresTheWidestCopiedLine)
+{
+	std::unique_ptr<TranslationSnapshot> pSnapshot = hookSnapshot();
+	TranslationEntry largest;
+	ScratchBuffer scratch;
+
+	stats::HookScope scope(stats::Hook::CopyFunc);
+	epoch::ReadGuard guard;
+
+	size_t length     = 0;
+	const char* pCopy = copyTranslation(pSnapshot.get(), "menu", scratch, scope, &largest, length);
+
+	CHECK(pCopy != nullptr && std::string(pCopy, length) == "Menu\nwith two lines");
+	CHECK(largest.pixelLength == 120);
+	CHECK(strcmp(largest.pText, "with two lines") == 0);
+
+	// A narrower copy keeps the widest line
+	CHECK(copyTranslation(pSnapshot.get(), "short", scratch, scope, &largest, length) != nullptr);
+	CHECK(largest.pixelLength == 120);
+	CHECK(copyTranslation(pSnapshot.get(), "missing", scratch, scope, &largest, length) == nullptr);
+
+	// The width is taken once from the widest line, afterwards from the translation again
+	CHECK(strcmp(widthString(pSnapshot.get(), "short", scope, largest), "with two lines") == 0);
+	CHECK(largest.pText == nullptr);
+	CHECK(strcmp(widthString(pSnapshot.get(), "short", scope, largest), "S") == 0);
+	CHECK(strcmp(widthString(pSnapshot.get(), "missing", scope, largest), "missing") == 0);
+
+	// Lines copied from an older snapshot are not used
+	CHECK(copyTranslation(pSnapshot.get(), "menu", scratch, scope, &largest, length) != nullptr);
+	pSnapshot->generation++;
+	CHECK(strcmp(widthString(pSnapshot.get(), "short", scope, largest), "S") == 0);
+
+	// Drawing resets the widest line
+	CHECK(copyTranslation(pSnapshot.get(), "menu", scratch, scope, &largest, length) != nullptr);
+	char buffer[64];
+	drawHook(pSnapshot.get(), largest, buffer, sizeof(buffer), "plain");
+	CHECK(largest.pText == nullptr);
+}
@@ -0,0 +1,242 @@
+/*
+ *  File: TranslationLoaderTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "../EternalRedirect/TranslationLoader.hpp"
+#include "../EternalRedirect/TranslationTable.hpp"
+#include "Test.hpp"
+
+// テキスト and 「こんにちは」 in UTF-8
+static const std::string KEY_PREFIX = "\xE3\x83\x86\xE3\x82\xAD\xE3\x82\xB9\xE3\x83\x88";
+static const std::string KEY_SUFFIX = "\xE3\x80\x8C\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF\xE3\x80\x8D";
+
+static std::string generatedKey(const size_t idx)
+{
+	return KEY_PREFIX + std::to_string(idx) + KEY_SUFFIX;
+}
+
+//
+// Writes a tr.json in the layout scripts/fix.py produces
+//
+static std::string writeTranslations(const std::string& name, const size_t count)
+{
+	const std::string path = (std::filesystem::temp_directory_path() / name).string();
+
+	std::ofstream file(path, std::ios::binary);
+	file << "{\n    \"window_title\": \"Eternal Romance\"";
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		file << ",\n    \"" << generatedKey(idx) << "\": {\n";
+		file << "        \"text\": \"Translated line " << idx << " of the script\\nwith a second line\",\n";
+		file << "        \"pixel_lengths\": [\n            " << idx % 500 << ",\n            180\n        ]\n    }";
+	}
+
+	file << "\n}\n";
+	return path;
+}
+
+//
+// The loader before the streaming one, it parses a whole nlohmann::json document first
+//
+static bool loadTranslationsDom(const std::string& path, TranslationTableBuilder& builder)
+{
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	nlohmann::json translations;
+	file >> translations;
+
+	builder.reserve(builder.size() + translations.size());
+
+	std::string sjisKey;
+	std::string sjisText;
+
+	for (const auto& [key, entry] : translations.items())
+	{
+		if (key == WINDOW_TITLE_KEY && entry.is_string())
+		{
+			builder.setWindowTitle(entry.get_ref<const std::string&>());
+			continue;
+		}
+
+		if (!entry.is_object() || !entry.contains("text") || !entry.contains("pixel_lengths"))
+			continue;
+
+		if (!entry["text"].is_string() || !entry["pixel_lengths"].is_array())
+			continue;
+
+		sjisKey.clear();
+		sjisText.clear();
+		cp932::appendSjis(key, sjisKey);
+		cp932::appendSjis(entry["text"].get_ref<const std::string&>(), sjisText);
+
+		builder.insert(sjisKey, sjisText, entry["pixel_lengths"].get<std::vector<uint32_t>>());
+	}
+
+	return true;
+}
+
+TEST_CASE(streamingLoaderMatchesDomLoader)
+{
+	const size_t count     = 2000;
+	const std::string path = writeTranslations("EternalRedirectLoaderTest.json", count);
+
+	TranslationTableBuilder streamBuilder;
+	std::vector<TranslationSchemaError> errors;
+	CHECK(loadTranslationsJson(path, streamBuilder, &errors));
+	CHECK(errors.empty());
+
+	TranslationTableBuilder domBuilder;
+	CHECK(loadTranslationsDom(path, domBuilder));
+
+	TranslationTable stream;
+	TranslationTable dom;
+	CHECK(stream.load(streamBuilder.build()));
+	CHECK(dom.load(domBuilder.build()));
+
+	CHECK(stream.size() == count);
+	CHECK(dom.size() == count);
+	CHECK(std::string(stream.windowTitle()) == dom.windowTitle());
+
+	std::string sjisKey;
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		sjisKey.clear();
+		cp932::appendSjis(generatedKey(idx), sjisKey);
+
+		TranslationView streamView;
+		TranslationView domView;
+		CHECK(stream.lookup(sjisKey, streamView));
+		CHECK(dom.lookup(sjisKey, domView));
+
+		CHECK(streamView.text == domView.text);
+		CHECK(streamView.pixelLengths.count == 2);
+		CHECK(streamView.pixelLengths[0] == domView.pixelLengths[0] && streamView.pixelLengths[1] == domView.pixelLengths[1]);
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(streamingLoaderReportsSchemaErrors)
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "EternalRedirectSchemaTest.json").string();
+
+	const std::string json = "{\"good\": {\"text\": \"Good\", \"pixel_lengths\": [10]},\n"
+	                         "\"no text\": {\"pixel_lengths\": [10]},\n"
+	                         "\"bad lengths\": {\"text\": \"Bad\", \"pixel_lengths\": [-1]},\n"
+	                         "\"%d damage\": {\"text\": \"%s damage\", \"pixel_lengths\": [10]}}";
+	std::ofstream(path, std::ios::binary) << json;
+
+	TranslationTableBuilder builder;
+	std::vector<TranslationSchemaError> errors;
+	CHECK(loadTranslationsJson(path, builder, &errors));
+
+	CHECK(builder.size() == 1);
+	CHECK(errors.size() == 3);
+
+	if (errors.size() == 3)
+	{
+		CHECK(errors[0].key == "no text" && errors[0].offset == json.find("\"no text\""));
+		CHECK(errors[1].key == "bad lengths" && errors[1].offset == json.find("-1"));
+		CHECK(errors[2].key == "%d damage" && errors[2].offset == json.find("\"%d damage\""));
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(streamingLoaderRejectsConversionsForUnparseableKeys)
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "EternalRedirectFormatKeyTest.json").string();
+
+	const std::string json = "{\"100%\": {\"text\": \"%s HP\", \"pixel_lengths\": [10]},\n"
+	                         "\"%d%\": {\"text\": \"%d%%\", \"pixel_lengths\": [10]},\n"
+	                         "\"50%\": {\"text\": \"50%% off\", \"pixel_lengths\": [10]}}";
+	std::ofstream(path, std::ios::binary) << json;
+
+	TranslationTableBuilder builder;
+	std::vector<TranslationSchemaError> errors;
+	CHECK(loadTranslationsJson(path, builder, &errors));
+
+	CHECK(builder.size() == 1);
+	CHECK(errors.size() == 2);
+
+	if (errors.size() == 2)
+	{
+		CHECK(errors[0].key == "100%" && errors[0].offset == json.find("\"100%\""));
+		CHECK(errors[1].key == "%d%" && errors[1].offset == json.find("\"%d%\""));
+	}
+
+	std::filesystem::remove(path);
+}
+
+//
+// Load time and peak memory for a generated 100k entry tr.json.
+// Pass "stream" or "dom" to run only one loader, the peak memory of a single run is not influenced by the other one.
+//
+BENCHMARK(loadTranslations100k)
+{
+	const std::string mode = args.empty() ? "" : args[0];
+	const std::string path = writeTranslations("EternalRedirectLoaderBench.json", 100000);
+
+	std::cout << "tr.json: " << std::filesystem::file_size(path) / (1024 * 1024) << " MiB" << std::endl;
+
+	for (const std::string loader : { "stream", "dom" })
+	{
+		if (!mode.empty() && mode != loader)
+			continue;
+
+		test::resetPeakMemory();
+		const size_t baseline = test::peakMemory();
+		const double start    = test::seconds();
+
+		TranslationTableBuilder builder;
+		if (loader == "stream")
+			loadTranslationsJson(path, builder);
+		else
+			loadTranslationsDom(path, builder);
+
+		TranslationTable table;
+		table.load(builder.build());
+
+		const double elapsed = test::seconds() - start;
+		const size_t peak    = test::peakMemory();
+
+		test::report(loader + " loader", elapsed, 1, std::filesystem::file_size(path));
+		std::cout << loader << " loader: peak RSS " << peak / (1024 * 1024) << " MiB, " << (peak - baseline) / (1024 * 1024) << " MiB above the baseline" << std::endl;
+	}
+
+	std::filesystem::remove(path);
+}
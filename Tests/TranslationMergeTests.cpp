@@ -0,0 +1,197 @@
+/*
+ *  File: TranslationMergeTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "../StringExtractor/TranslationMerge.hpp"
+#include "Test.hpp"
+
+static const std::filesystem::path MERGE_DIRECTORY = std::filesystem::temp_directory_path() / "EternalRedirectMergeTest";
+
+// Section data with the strings in Shift-JIS, each followed by a zero
+static std::string sectionData(const std::vector<std::string>& strings)
+{
+	std::string data;
+
+	for (const std::string& string : strings)
+	{
+		cp932::appendSjis(string, data);
+		data.push_back('\0');
+	}
+
+	return data;
+}
+
+static std::vector<DataSection> dataSections(const std::string& data)
+{
+	return { { ".data", 0x1000, data } };
+}
+
+static std::string readFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static std::string writeFile(const std::string& name, const std::string& contents)
+{
+	std::filesystem::remove_all(MERGE_DIRECTORY);
+	std::filesystem::create_directories(MERGE_DIRECTORY);
+
+	const std::filesystem::path path = MERGE_DIRECTORY / name;
+	std::ofstream(path, std::ios::binary) << contents;
+
+	return path.string();
+}
+
+TEST_CASE(mergeAddsObjectEntriesAndListsVanishedOnes)
+{
+	const std::string original = R"({"window_title": "Title", "こんにちは": {"text": "Hello", "pixel_lengths": [40]}, "古い": {"text": "Old", "pixel_lengths": [30]}})";
+	const std::string path     = writeFile("tr.json", original);
+	const std::string data     = sectionData({ "こんにちは", "さようなら" });
+
+	const MergeResult result = mergeTranslations(dataSections(data), path);
+	CHECK(!result.upToDate);
+	CHECK(result.keptCount == 3);
+	CHECK(result.addedCount == 1);
+	CHECK(result.vanishedCount == 1);
+
+	const nlohmann::json merged = nlohmann::json::parse(readFile(path));
+	CHECK(merged["window_title"] == "Title");
+	CHECK(merged["こんにちは"]["text"] == "Hello");
+	CHECK(merged["古い"]["text"] == "Old");
+	CHECK(merged["さようなら"] == nlohmann::json::parse(R"({"text": "", "pixel_lengths": [0]})"));
+
+	// The list of vanished strings belongs to the file, not to the working directory
+	CHECK(nlohmann::json::parse(readFile(MERGE_DIRECTORY / "vanished.json")) == nlohmann::json::parse(R"(["古い"])"));
+	CHECK(readFile(path + ".bak") == original);
+
+	std::filesystem::remove_all(MERGE_DIRECTORY);
+}
+
+TEST_CASE(mergeAddsPlainStringsToStringFiles)
+{
+	const std::string path = writeFile("tr.json", R"({"window_title": "Title", "こんにちは": "Hello"})");
+	const std::string data = sectionData({ "こんにちは", "さようなら" });
+
+	const MergeResult result = mergeTranslations(dataSections(data), path);
+	CHECK(result.addedCount == 1);
+	CHECK(result.vanishedCount == 0);
+
+	const nlohmann::json merged = nlohmann::json::parse(readFile(path));
+	CHECK(merged["こんにちは"] == "Hello");
+	CHECK(merged["さようなら"] == "");
+
+	std::filesystem::remove_all(MERGE_DIRECTORY);
+}
+
+TEST_CASE(mergeDropsCarriageReturnsOfExistingValues)
+{
+	const std::string path = writeFile("tr.json", "{\r\n  \"こんにちは\": {\r\n    \"text\": \"Hello\",\r\n    \"pixel_lengths\": [\r\n      40\r\n    ]\r\n  }\r\n}\r\n");
+	const std::string data = sectionData({ "こんにちは", "さようなら" });
+
+	mergeTranslations(dataSections(data), path);
+
+	// Read in text mode, so the line ends the stream adds on Windows are removed again
+	const std::string merged = readFile(path);
+	CHECK(merged.find('\r') == std::string::npos);
+	CHECK(nlohmann::json::parse(merged)["こんにちは"]["pixel_lengths"][0] == 40);
+
+	std::filesystem::remove_all(MERGE_DIRECTORY);
+}
+
+TEST_CASE(mergeSkipsExtractionWhenUpToDate)
+{
+	const std::string path = writeFile("tr.json", R"({"こんにちは": "Hello", "古い": "Old"})");
+	const std::string data = sectionData({ "こんにちは", "さようなら" });
+
+	mergeTranslations(dataSections(data), path);
+	const std::string merged = readFile(path);
+
+	const MergeResult result = mergeTranslations(dataSections(data), path);
+	CHECK(result.upToDate);
+	CHECK(result.addedCount == 0);
+	CHECK(result.vanishedCount == 1);
+	CHECK(readFile(path) == merged);
+
+	// A string the index knows about is missing from the file, so it has to be added again
+	std::ofstream(path, std::ios::binary) << R"({"こんにちは": "Hello"})";
+
+	const MergeResult removed = mergeTranslations(dataSections(data), path);
+	CHECK(!removed.upToDate);
+	CHECK(removed.addedCount == 1);
+
+	// Changed section contents make the index stale
+	const std::string changedData = sectionData({ "こんにちは", "さようなら", "新しい" });
+
+	const MergeResult changed = mergeTranslations(dataSections(changedData), path);
+	CHECK(!changed.upToDate);
+	CHECK(changed.addedCount == 1);
+	CHECK(nlohmann::json::parse(readFile(path))["新しい"] == "");
+
+	std::filesystem::remove_all(MERGE_DIRECTORY);
+}
+
+TEST_CASE(mergeIgnoresDamagedIndex)
+{
+	const std::string path      = writeFile("tr.json", R"({"こんにちは": "Hello"})");
+	const std::string indexPath = path + ".index";
+	const std::string data      = sectionData({ "こんにちは", "さようなら" });
+
+	mergeTranslations(dataSections(data), path);
+
+	// Cut off within the key hashes
+	std::filesystem::resize_file(indexPath, std::filesystem::file_size(indexPath) - 4);
+
+	const MergeResult truncated = mergeTranslations(dataSections(data), path);
+	CHECK(!truncated.upToDate);
+	CHECK(truncated.addedCount == 0);
+
+	// Key count far beyond the size of the file
+	{
+		std::fstream index(indexPath, std::ios::in | std::ios::out | std::ios::binary);
+		index.seekp(16);
+		const uint64_t keyCount = ~0ull;
+		index.write(reinterpret_cast<const char*>(&keyCount), sizeof(keyCount));
+	}
+
+	const MergeResult damaged = mergeTranslations(dataSections(data), path);
+	CHECK(!damaged.upToDate);
+
+	// Cut off within the header
+	std::filesystem::resize_file(indexPath, 8);
+	CHECK(!mergeTranslations(dataSections(data), path).upToDate);
+
+	CHECK(mergeTranslations(dataSections(data), path).upToDate);
+
+	std::filesystem::remove_all(MERGE_DIRECTORY);
+}
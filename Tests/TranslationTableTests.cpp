@@ -0,0 +1,96 @@
+/*
+ *  File: TranslationTableTests.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <filesystem>
+#include <string>
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "../EternalRedirect/TranslationTable.hpp"
+#include "Test.hpp"
+
+//
+// The loader stores keys the way cp932::appendSjis encodes them, the game may draw any form of a duplicate character
+//
+TEST_CASE(lookupFindsEveryFormOfDuplicateCharacters)
+{
+	// 纊 is 0xFA5C or 0xED40, ￢ is 0x81CA, 0xFA54 or 0xEEF9, Ⅰ is 0x8754 or 0xFA4A, ≒ is 0x81E0 or 0x8790
+	std::string key;
+	cp932::appendSjis("\xE7\xBA\x8A\xE3\x81\x82\xEF\xBF\xA2\xE2\x85\xA0\xE2\x89\x92", key);
+	CHECK(key == "\xFA\x5C\x82\xA0\x81\xCA\x87\x54\x81\xE0");
+
+	TranslationTableBuilder builder;
+	builder.insert(key, "first", {});
+	builder.insert("\x81\xCA", "second", {});
+
+	TranslationTable table;
+	CHECK(table.load(builder.build()));
+	CHECK(table.size() == 2);
+
+	const uint32_t entry = table.find(key);
+	CHECK(entry != TranslationTable::NPOS);
+	CHECK(table.find("\xED\x40\x82\xA0\xEE\xF9\xFA\x4A\x87\x90") == entry);
+	CHECK(table.find("\xFA\x5C\x82\xA0\xFA\x54\x87\x54\x81\xE0") == entry);
+
+	for (const char* pForm : { "\x81\xCA", "\xFA\x54", "\xEE\xF9" })
+		CHECK(table.text(table.find(pForm)) == "second");
+
+	// Keys too long for the stack buffer take the per thread buffer
+	const std::string longKey = std::string(2000, 'a') + "\xED\x40";
+
+	TranslationTableBuilder longBuilder;
+	longBuilder.insert(std::string(2000, 'a') + "\xFA\x5C", "long", {});
+
+	TranslationTable longTable;
+	CHECK(longTable.load(longBuilder.build()));
+	CHECK(longTable.find(longKey) != TranslationTable::NPOS);
+}
+
+TEST_CASE(writePackFileReplacesMappedPack)
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "EternalRedirectTests.pack").string();
+
+	TranslationTableBuilder builder;
+	builder.insert("key", "first", {});
+	writePackFile(path, builder.build());
+
+	TranslationTable mapped;
+	CHECK(mapped.map(path));
+
+	builder.insert("key", "second", {});
+	writePackFile(path, builder.build());
+
+	// The old mapping stays valid while the new pack is already in place
+	CHECK(mapped.text(mapped.find("key")) == "first");
+
+	TranslationTable reloaded;
+	CHECK(reloaded.map(path));
+	CHECK(reloaded.text(reloaded.find("key")) == "second");
+	CHECK(!std::filesystem::exists(path + ".tmp"));
+
+	mapped.clear();
+	reloaded.clear();
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,90 @@
+/*
+ *  File: TrCompiler.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <exception>
+#include <format>
+#include <iostream>
+#include <vector>
+
+#include "../EternalRedirect/FontMetrics.hpp"
+#include "../EternalRedirect/TranslationLoader.hpp"
+#include "../EternalRedirect/TranslationTable.hpp"
+
+//
+// Compiles a tr.json file into the binary pack format the DLL maps at startup
+//
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 4)
+	{
+		std::cout << std::format("Usage: {} <path_to_tr.json> [path_to_output.pack] [path_to_font.ttf]", argv[0]) << std::endl;
+		return 1;
+	}
+
+	const std::string source = argv[1];
+	const std::string target = (argc >= 3) ? argv[2] : "tr.pack";
+
+	try
+	{
+		TranslationTableBuilder builder;
+		std::vector<TranslationSchemaError> errors;
+
+		// Entries without pixel lengths are measured with the font if one is given
+		FontMetrics font;
+		if (argc == 4 && !font.open(argv[3], FONT_SIZE))
+			throw std::runtime_error(std::format("Failed to open font: {}", argv[3]));
+
+		std::cout << "Loading translations ... " << std::flush;
+		if (!loadTranslationsJson(source, builder, &errors, font.isOpen() ? &font : nullptr))
+			throw std::runtime_error(std::format("Failed to open file: {}", source));
+		std::cout << "Done" << std::endl;
+
+		for (const TranslationSchemaError& error : errors)
+			std::cerr << std::format("Warning: Skipped entry \"{}\" at byte {}: {}", error.key, error.offset, error.message) << std::endl;
+
+		std::cout << "Building pack ... " << std::flush;
+		std::vector<uint8_t> data = builder.build();
+		std::cout << "Done" << std::endl;
+
+		// Make sure the DLL will accept the result
+		TranslationTable table;
+		if (!table.load(std::vector<uint8_t>(data)) || table.size() != builder.size())
+			throw std::runtime_error("Validation of the generated pack failed");
+
+		std::cout << "Writing pack ... " << std::flush;
+		writePackFile(target, data);
+		std::cout << "Done" << std::endl;
+
+		std::cout << std::format("Total entries: {}, pack size: {} bytes", table.size(), data.size()) << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ *  File: TrFixer.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../EternalRedirect/Cp932.hpp"
+#include "../EternalRedirect/FontMetrics.hpp"
+#include "../EternalRedirect/FormatString.hpp"
+#include "../EternalRedirect/TranslationLoader.hpp"
+#include "../EternalRedirect/TranslationTable.hpp"
+#include "TranslationFixer.hpp"
+
+static const std::string DEFAULT_SOURCE = "tr_org.json";
+static const std::string DEFAULT_TARGET = "tr.json";
+static const std::string PACK_EXTENSION = ".pack";
+
+//
+// Builds the same pack TrCompiler would create from the tr.json written by toJson
+//
+static std::vector<uint8_t> toPack(const Translations& translations)
+{
+	TranslationTableBuilder builder;
+	builder.reserve(translations.entries.size());
+
+	std::string sjisKey;
+	std::string sjisText;
+
+	for (const Translation& entry : translations.entries)
+	{
+		sjisKey.clear();
+		sjisText.clear();
+		cp932::appendSjis(entry.key, sjisKey);
+		cp932::appendSjis(entry.text, sjisText);
+
+		// Same check as when the DLL loads tr.json
+		if (!isCompatibleFormat(sjisKey, sjisText))
+		{
+			std::cerr << std::format("Warning: Skipped entry \"{}\": \"text\" does not use the same format conversions as the key", entry.key) << std::endl;
+			continue;
+		}
+
+		builder.insert(sjisKey, sjisText, entry.pixelLengths);
+	}
+
+	std::vector<uint8_t> data = builder.build();
+
+	// Make sure the DLL will accept the result
+	TranslationTable table;
+	if (!table.load(std::vector<uint8_t>(data)) || table.size() != builder.size())
+		throw std::runtime_error("Validation of the generated pack failed");
+
+	return data;
+}
+
+//
+// Native replacement for scripts/fix.py, writes tr.json or a compiled pack if the output ends with .pack
+//
+int main(int argc, char* argv[])
+{
+	if (argc > 4)
+	{
+		std::cout << std::format("Usage: {} [path_to_tr_org.json] [path_to_output.json|.pack] [path_to_font.ttf]", argv[0]) << std::endl;
+		return 1;
+	}
+
+	const std::string source   = (argc >= 2) ? argv[1] : DEFAULT_SOURCE;
+	const std::string target   = (argc >= 3) ? argv[2] : DEFAULT_TARGET;
+	const std::string fontPath = (argc >= 4) ? argv[3] : FONT_FILE;
+
+	const bool writePack = target.size() >= PACK_EXTENSION.size() && target.compare(target.size() - PACK_EXTENSION.size(), PACK_EXTENSION.size(), PACK_EXTENSION) == 0;
+
+	try
+	{
+		FontMetrics font;
+		if (!font.open(fontPath, FONT_SIZE))
+			throw std::runtime_error(std::format("Failed to open font: {}", fontPath));
+
+		std::cout << "Loading translations ... " << std::flush;
+		Translations translations = loadTranslations(source);
+		std::cout << "Done" << std::endl;
+
+		std::cout << "Fixing box lengths ... " << std::flush;
+		const size_t fixCount = fixBoxLengths(translations, font);
+		std::cout << "Done" << std::endl;
+
+		std::cout << "Measuring lines ... " << std::flush;
+		measureTranslations(translations, font);
+		std::cout << "Done" << std::endl;
+
+		std::cout << std::format("Writing {} ... ", writePack ? "pack" : "translations") << std::flush;
+
+		if (writePack)
+			writePackFile(target, toPack(translations));
+		else
+		{
+			// tr.json uses text mode like the script, so line endings match on every platform
+			std::ofstream outFile(target);
+			if (!outFile)
+				throw std::runtime_error(std::format("Failed to create file: {}", target));
+
+			writeJson(translations, outFile);
+			outFile.close();
+		}
+		std::cout << "Done" << std::endl;
+
+		std::cout << std::format("Total entries: {}, box length fixes: {}", translations.entries.size(), fixCount) << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
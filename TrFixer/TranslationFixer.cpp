@@ -0,0 +1,252 @@
+/*
+ *  File: TranslationFixer.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+#include "TranslationFixer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+#include "../EternalRedirect/JsonReader.hpp"
+#include "../EternalRedirect/JsonWriter.hpp"
+#include "../EternalRedirect/MappedFile.hpp"
+
+// Number of entries a worker thread takes at once
+static const size_t WORK_CHUNK_SIZE = 256;
+
+//
+// Calls func for every index below count, spread over all cores
+//
+static void parallelFor(const size_t count, const std::function<void(const size_t)>& func)
+{
+	std::atomic<size_t> next = 0;
+
+	const auto worker = [&]() {
+		while (true)
+		{
+			const size_t begin = next.fetch_add(WORK_CHUNK_SIZE);
+			if (begin >= count)
+				return;
+
+			const size_t end = (std::min)(begin + WORK_CHUNK_SIZE, count);
+			for (size_t idx = begin; idx < end; idx++)
+				func(idx);
+		}
+	};
+
+	const uint32_t threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+	std::vector<std::thread> threads;
+
+	for (uint32_t i = 1; i < threadCount; i++)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+static void splitLines(std::string_view text, std::vector<std::string_view>& outLines)
+{
+	outLines.clear();
+
+	size_t lineStart = 0;
+
+	while (true)
+	{
+		const size_t lineEnd = text.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos)
+			break;
+
+		outLines.push_back(text.substr(lineStart, lineEnd - lineStart));
+		lineStart = lineEnd + 1;
+	}
+
+	outLines.push_back(text.substr(lineStart));
+}
+
+// Length in code points, same as len() of the Python string
+static size_t codePointCount(std::string_view utf8)
+{
+	return std::count_if(utf8.begin(), utf8.end(), [](const char c) { return (static_cast<uint8_t>(c) & 0xC0) != 0x80; });
+}
+
+Translations loadTranslations(const std::string& path)
+{
+	MappedFile file;
+	if (!file.open(path))
+		throw std::runtime_error("Failed to open file: " + path);
+
+	JsonReader reader(reinterpret_cast<const char*>(file.data()), file.size());
+	Translations translations;
+
+	reader.expect('{');
+
+	if (!reader.consume('}'))
+	{
+		do
+		{
+			std::string key(reader.readString());
+			reader.expect(':');
+
+			if (reader.peek() != '"')
+				reader.fail("translation of \"" + key + "\" is not a string");
+
+			const std::string_view text = reader.readString();
+
+			const auto it = translations.index.find(key);
+			if (it != translations.index.end())
+			{
+				translations.entries[it->second].text.assign(text);
+				continue;
+			}
+
+			Translation& entry = translations.entries.emplace_back();
+			entry.key          = std::move(key);
+			entry.text.assign(text);
+
+			translations.index.emplace(entry.key, translations.entries.size() - 1);
+		} while (reader.consume(','));
+
+		reader.expect('}');
+	}
+
+	if (!reader.atEnd())
+		reader.fail("unexpected data after the translations");
+
+	return translations;
+}
+
+size_t fixBoxLengths(Translations& translations, const FontMetrics& font)
+{
+	struct BoxFix
+	{
+		size_t target = SIZE_MAX;
+		std::string_view text;
+	};
+
+	std::vector<BoxFix> fixes(translations.entries.size());
+
+	// Only texts of keys with several lines are read and only texts of keys without one are written,
+	// so all replacements can be searched in parallel and applied in file order afterwards
+	parallelFor(fixes.size(), [&](const size_t idx) {
+		const Translation& entry = translations.entries[idx];
+		if (entry.key.find('\n') == std::string::npos)
+			return;
+
+		std::vector<std::string_view> parts;
+		splitLines(entry.key, parts);
+
+		// On ties the later line wins, like the >= in the script
+		size_t target       = SIZE_MAX;
+		size_t targetLength = 0;
+
+		for (const std::string_view part : parts)
+		{
+			const auto it = translations.index.find(part);
+			if (it == translations.index.end())
+				continue;
+
+			const size_t length = codePointCount(part);
+			if (target == SIZE_MAX || length >= targetLength)
+			{
+				target       = it->second;
+				targetLength = length;
+			}
+		}
+
+		if (target == SIZE_MAX)
+			return;
+
+		// max() with (pixel length, text) as key, byte order of UTF-8 equals code point order
+		splitLines(entry.text, parts);
+
+		std::string_view widest = parts[0];
+		uint32_t widestLength   = font.lineWidth(widest);
+
+		for (size_t i = 1; i < parts.size(); i++)
+		{
+			const uint32_t length = font.lineWidth(parts[i]);
+			if (length > widestLength || (length == widestLength && parts[i] > widest))
+			{
+				widest       = parts[i];
+				widestLength = length;
+			}
+		}
+
+		fixes[idx] = { target, widest };
+	});
+
+	size_t fixCount = 0;
+
+	for (const BoxFix& fix : fixes)
+	{
+		if (fix.target == SIZE_MAX)
+			continue;
+
+		translations.entries[fix.target].text.assign(fix.text);
+		fixCount++;
+	}
+
+	return fixCount;
+}
+
+void measureTranslations(Translations& translations, const FontMetrics& font)
+{
+	parallelFor(translations.entries.size(), [&](const size_t idx) {
+		Translation& entry = translations.entries[idx];
+		font.lineWidths(entry.text, entry.pixelLengths);
+	});
+}
+
+void writeJson(const Translations& translations, std::ostream& stream)
+{
+	JsonWriter writer(stream);
+
+	writer.beginObject();
+
+	for (const Translation& entry : translations.entries)
+	{
+		writer.key(entry.key);
+		writer.beginObject();
+
+		writer.key("text");
+		writer.string(entry.text);
+
+		writer.key("pixel_lengths");
+		writer.beginArray();
+
+		for (const uint32_t length : entry.pixelLengths)
+			writer.number(length);
+
+		writer.endArray();
+		writer.endObject();
+	}
+
+	writer.endObject();
+}
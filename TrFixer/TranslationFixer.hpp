@@ -0,0 +1,75 @@
+/*
+ *  File: TranslationFixer.hpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../EternalRedirect/FontMetrics.hpp"
+
+struct Translation
+{
+	std::string key;
+	std::string text;
+	std::vector<uint32_t> pixelLengths;
+};
+
+//
+// Translations in file order. Like a Python dict a repeated key replaces the text but keeps its first position.
+// The deque never moves its elements, so the index can refer to the keys stored in them.
+//
+struct Translations
+{
+	std::deque<Translation> entries;
+	std::unordered_map<std::string_view, size_t> index;
+};
+
+//
+// Reads tr_org.json, an object mapping each original text to its translation.
+// Throws std::runtime_error if the file can not be read.
+//
+Translations loadTranslations(const std::string& path);
+
+//
+// Port of fix_box_length_string from scripts/fix.py.
+// For every key with several lines, the longest of its lines that has an entry of its own
+// gets the widest line of the translation as text. Returns the number of replaced texts.
+//
+size_t fixBoxLengths(Translations& translations, const FontMetrics& font);
+
+// Port of add_pixel_length_info from scripts/fix.py, the font caches the glyph metrics and is shared by all threads
+void measureTranslations(Translations& translations, const FontMetrics& font);
+
+//
+// Streams the translations in the layout json.dump(data, file, ensure_ascii=False, indent=4) uses in scripts/fix.py
+//
+void writeJson(const Translations& translations, std::ostream& stream);
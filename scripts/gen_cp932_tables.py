@@ -0,0 +1,120 @@
+import sys
+
+# Generates EternalRedirect/Cp932Tables.cpp from the cp932 codec shipped with Python,
+# which follows the Microsoft mapping used by MultiByteToWideChar(932, ...).
+# Python encodes characters with several Shift-JIS forms differently than WideCharToMultiByte(932, ...),
+# so the encode table picks the form Windows prefers instead, see encode_priority.
+
+OUTPUT_PATH = "../EternalRedirect/Cp932Tables.cpp"
+
+LEAD_BYTES  = list(range(0x81, 0xA0)) + list(range(0xE0, 0xFD))
+TRAIL_FIRST = 0x40
+TRAIL_LAST  = 0xFC
+
+HEADER = """/*
+ *  File: Cp932Tables.cpp
+ *  Copyright (c) 2025 Sinflower
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ */
+
+// Generated by scripts/gen_cp932_tables.py, do not edit
+"""
+
+# Code point of a double byte character or 0 if the pair is not mapped
+def decode_pair(lead, trail):
+	try:
+		text = bytes([lead, trail]).decode("cp932")
+	except UnicodeDecodeError:
+		return 0
+
+	return ord(text) if len(text) == 1 else 0
+
+# Windows encodes a character that has several forms with the first of: JIS X 0208, NEC row 13,
+# IBM extensions, NEC selected IBM extensions. Python prefers the NEC selected form for the IBM kanji.
+def encode_priority(lead):
+	if lead == 0x87:
+		return 1
+	if 0xFA <= lead <= 0xFC:
+		return 2
+	if 0xED <= lead <= 0xEE:
+		return 3
+	return 0
+
+# Shift-JIS bytes of a BMP code point packed into an uint16_t or 0 if it is not mapped
+def encode_code_point(code_point, decoded_forms):
+	if 0xD800 <= code_point < 0xE000:
+		return 0
+
+	forms = decoded_forms.get(code_point)
+	if forms:
+		return min(forms, key=lambda form: (encode_priority(form >> 8), form))
+
+	try:
+		data = chr(code_point).encode("cp932")
+	except UnicodeEncodeError:
+		return 0
+
+	return data[0] if len(data) == 1 else (data[0] << 8) | data[1]
+
+def write_array(out, declaration, values, digits=4):
+	out.write(declaration + " = {\n")
+	for i in range(0, len(values), 16):
+		out.write("\t" + ", ".join("0x%0*X" % (digits, v) for v in values[i:i + 16]) + ",\n")
+	out.write("};\n")
+
+def main():
+	output_path = sys.argv[1] if len(sys.argv) > 1 else OUTPUT_PATH
+
+	double_bytes  = []
+	decoded_forms = {}
+	for lead in LEAD_BYTES:
+		for trail in range(TRAIL_FIRST, TRAIL_LAST + 1):
+			code_point = decode_pair(lead, trail)
+			double_bytes.append(code_point)
+
+			if code_point != 0:
+				decoded_forms.setdefault(code_point, []).append((lead << 8) | trail)
+
+	# Code points below 0x80 are ASCII and never looked up, so page 0 only holds the upper half
+	page_index = [0] * 256
+	pages      = []
+	for page in range(256):
+		values = [encode_code_point((page << 8) | low, decoded_forms) if (page << 8) | low >= 0x80 else 0 for low in range(256)]
+		if any(values):
+			pages.append(values)
+			page_index[page] = len(pages)
+
+	with open(output_path, "w", newline="\n") as out:
+		out.write(HEADER)
+		out.write("\n#include \"Cp932.hpp\"\n\nnamespace cp932\n{\n")
+		write_array(out, "const uint16_t DOUBLE_BYTE_TABLE[LEAD_COUNT * TRAIL_COUNT]", double_bytes)
+		out.write("\n")
+		write_array(out, "const uint8_t UNICODE_PAGE_INDEX[256]", page_index, 2)
+		out.write("\n")
+		write_array(out, "const uint16_t UNICODE_PAGES[]", [v for page in pages for v in page])
+		out.write("} // namespace cp932\n")
+
+	print("Double byte characters: %d, unicode pages: %d" % (sum(1 for v in double_bytes if v), len(pages)))
+
+if __name__ == "__main__":
+	main()